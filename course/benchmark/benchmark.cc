@@ -0,0 +1,96 @@
+#include "benchmark.h"
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+namespace {
+
+std::atomic<uint64_t> allocation_count{0};
+std::atomic<uint64_t> allocated_bytes{0};
+
+void WriteJsonString(std::FILE *file, const std::string& value) {
+    std::fputc('"', file);
+    for (const char c : value) {
+        if (c == '"' || c == '\\') {
+            std::fputc('\\', file);
+        }
+        std::fputc(c, file);
+    }
+    std::fputc('"', file);
+}
+
+}  // namespace
+
+void* operator new(std::size_t size) {
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+    if (void* pointer = std::malloc(size == 0 ? 1 : size)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept { std::free(pointer); }
+
+void operator delete(void* pointer, std::size_t) noexcept { std::free(pointer); }
+
+namespace ekumen {
+namespace benchmark {
+
+uint64_t AllocationCount() { return allocation_count.load(std::memory_order_relaxed); }
+
+uint64_t AllocatedBytes() { return allocated_bytes.load(std::memory_order_relaxed); }
+
+Options ParseOptions(int argc, char **argv, const uint64_t default_iterations) {
+    static constexpr char kIterations[] = "--iterations=";
+    static constexpr char kJson[] = "--json=";
+    Options options{default_iterations, ""};
+    for (int i = 1; i < argc; ++i) {
+        if (std::strncmp(argv[i], kIterations, sizeof(kIterations) - 1) == 0) {
+            options.iterations = std::strtoull(argv[i] + sizeof(kIterations) - 1, nullptr, 10);
+        } else if (std::strncmp(argv[i], kJson, sizeof(kJson) - 1) == 0) {
+            options.json_path = argv[i] + sizeof(kJson) - 1;
+        } else {
+            std::fprintf(stderr, "Unknown argument: %s\n", argv[i]);
+        }
+    }
+    if (options.iterations == 0) {
+        options.iterations = 1;
+    }
+    return options;
+}
+
+void Reporter::Add(const Result& result) {
+    std::printf("%-40s %12.2f ns/op %8.2f allocs/op %10.2f B/op\n", result.name.c_str(), result.ns_per_op,
+                result.allocs_per_op, result.bytes_per_op);
+    results_.push_back(result);
+}
+
+int Reporter::Finish() const {
+    if (options_.json_path.empty()) {
+        return 0;
+    }
+    std::FILE *file = std::fopen(options_.json_path.c_str(), "w");
+    if (file == nullptr) {
+        std::fprintf(stderr, "Could not open %s\n", options_.json_path.c_str());
+        return 1;
+    }
+    std::fprintf(file, "{\"benchmarks\": [");
+    for (size_t i = 0; i < results_.size(); ++i) {
+        const Result& result = results_[i];
+        std::fprintf(file, "%s\n  {\"name\": ", i == 0 ? "" : ",");
+        WriteJsonString(file, result.name);
+        std::fprintf(file,
+                     ", \"iterations\": %llu, \"ns_per_op\": %.3f, \"allocs_per_op\": %.3f, \"bytes_per_op\": %.3f}",
+                     static_cast<unsigned long long>(result.iterations), result.ns_per_op, result.allocs_per_op,
+                     result.bytes_per_op);
+    }
+    std::fprintf(file, "\n]}\n");
+    return std::fclose(file) == 0 ? 0 : 1;
+}
+
+}  // namespace benchmark
+}  // namespace ekumen
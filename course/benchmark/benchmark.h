@@ -0,0 +1,106 @@
+#pragma once
+
+// Standard libraries
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ekumen {
+namespace benchmark {
+
+// Process wide allocation counters, fed by the global operator new replacement
+// in benchmark.cc.
+uint64_t AllocationCount();
+uint64_t AllocatedBytes();
+
+struct Result {
+    std::string name;
+    uint64_t iterations;
+    double ns_per_op;
+    double allocs_per_op;
+    double bytes_per_op;
+};
+
+// Command line options shared by every benchmark executable:
+//   --iterations=<n>  number of calls per benchmark case.
+//   --json=<path>     also writes the results as JSON to <path>.
+struct Options {
+    uint64_t iterations;
+    std::string json_path;
+};
+
+Options ParseOptions(int argc, char **argv, const uint64_t default_iterations);
+
+// Keeps the compiler from optimizing away a value computed inside a benchmark.
+template <class T>
+inline void DoNotOptimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// Makes the compiler forget what it knows about |value|, so a benchmark whose inputs are
+// known constants measures the computation rather than a result folded at compile time.
+// DoNotOptimize() only keeps the result alive. Call it on every input inside the function.
+template <class T>
+inline void MakeOpaque(T& value) {
+    asm volatile("" : "+r,m"(value) : : "memory");
+}
+
+// Runs |function| |iterations| times and reports time and allocations per item, where every call
+// processes |items| items.
+template <class Function>
+Result RunBatch(const std::string& name, const uint64_t iterations, const uint64_t items, Function&& function) {
+    const uint64_t allocations_start = AllocationCount();
+    const uint64_t bytes_start = AllocatedBytes();
+    const auto start = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < iterations; ++i) {
+        function();
+    }
+    const auto end = std::chrono::steady_clock::now();
+    // Counters are sampled before |name| is copied into the result.
+    const uint64_t allocations = AllocationCount() - allocations_start;
+    const uint64_t bytes = AllocatedBytes() - bytes_start;
+    const double elapsed_ns = std::chrono::duration<double, std::nano>(end - start).count();
+    const double operations = static_cast<double>(iterations) * items;
+    return Result{name, iterations * items, elapsed_ns / operations, allocations / operations, bytes / operations};
+}
+
+// Runs |function| |iterations| times and reports time and allocations per call.
+template <class Function>
+Result Run(const std::string& name, const uint64_t iterations, Function&& function) {
+    return RunBatch(name, iterations, 1, function);
+}
+
+// Collects results, prints them as a table and optionally writes them as JSON:
+// {"benchmarks": [{"name": ..., "iterations": ..., "ns_per_op": ...,
+//                  "allocs_per_op": ..., "bytes_per_op": ...}, ...]}
+class Reporter {
+    public:
+        explicit Reporter(const Options& options) : options_(options) {};
+
+        // Runs a benchmark case with the configured iterations and records it.
+        template <class Function>
+        void Run(const std::string& name, Function&& function) {
+            Add(benchmark::Run(name, options_.iterations, function));
+        }
+
+        // Runs a benchmark case that processes |items| items per call, keeping the total number of
+        // processed items close to the configured iterations.
+        template <class Function>
+        void RunBatch(const std::string& name, const uint64_t items, Function&& function) {
+            const uint64_t calls = options_.iterations > items ? options_.iterations / items : 1;
+            Add(benchmark::RunBatch(name, calls, items, function));
+        }
+
+        void Add(const Result& result);
+
+        // Writes the JSON report if requested. Returns a process exit code.
+        int Finish() const;
+
+    private:
+        Options options_;
+        std::vector<Result> results_;
+};
+
+}  // namespace benchmark
+}  // namespace ekumen
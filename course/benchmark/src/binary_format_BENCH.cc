@@ -0,0 +1,64 @@
+// Benchmarks writing and reading trajectories in the binary format against the text printer.
+#include "binary_format.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "benchmark.h"
+
+namespace ekumen {
+namespace math {
+namespace {
+
+constexpr uint64_t kDefaultIterations{1000000};
+constexpr size_t kPoses{100000};
+
+void RunBinaryFormatBenchmarks(benchmark::Reporter& reporter) {
+    const std::string path = "binary_format_BENCH.bin";
+    std::vector<Isometry> poses;
+    for (size_t i = 0; i < kPoses; ++i) {
+        poses.push_back(Isometry::FromTranslation(Vector3{0.01 * i, 2., 3.}) *
+                        Isometry::RotateAround(Vector3::kUnitZ, 1e-3 * i));
+    }
+
+    reporter.RunBatch("operator<< trajectory", kPoses, [&]() {
+        std::ostringstream stream;
+        for (const Isometry& pose : poses) {
+            stream << pose << '\n';
+        }
+        benchmark::DoNotOptimize(stream.tellp());
+    });
+    reporter.RunBatch("TrajectoryWriter::append", kPoses, [&]() {
+        TrajectoryWriter writer(path);
+        writer.append(poses.data(), poses.size());
+        writer.close();
+    });
+    const TrajectoryReader reader(path);
+    size_t next{0};
+    reporter.Run("TrajectoryReader::pose random seek", [&]() {
+        next = (next * 7919 + 13) % kPoses;
+        benchmark::DoNotOptimize(reader.pose(next));
+    });
+    reporter.RunBatch("TrajectoryReader open and scan", kPoses, [&]() {
+        const TrajectoryReader scan(path);
+        double sum{0.};
+        for (size_t i = 0; i < scan.size(); ++i) {
+            sum += scan.pose(i).translation().x();
+        }
+        benchmark::DoNotOptimize(sum);
+    });
+    std::remove(path.c_str());
+}
+
+}  // namespace
+}  // namespace math
+}  // namespace ekumen
+
+int main(int argc, char **argv) {
+    ekumen::benchmark::Reporter reporter(ekumen::benchmark::ParseOptions(argc, argv, ekumen::math::kDefaultIterations));
+    ekumen::math::RunBinaryFormatBenchmarks(reporter);
+    return reporter.Finish();
+}
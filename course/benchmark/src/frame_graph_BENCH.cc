@@ -0,0 +1,59 @@
+// Micro benchmarks for FrameGraph lookups against composing the chain by hand.
+#include "frame_graph.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "benchmark.h"
+
+namespace ekumen {
+namespace math {
+namespace {
+
+constexpr uint64_t kDefaultIterations{1000000};
+constexpr int kChainLength{12};
+
+void RunFrameGraphBenchmarks(benchmark::Reporter& reporter) {
+    FrameGraph graph;
+    std::vector<Isometry> edges;
+    graph.addFrame("frame_0");
+    for (int i = 1; i <= kChainLength; ++i) {
+        edges.push_back(Isometry::FromTranslation(Vector3{0.1 * i, -0.2, 0.3}) *
+                        Isometry::RotateAround(Vector3::kUnitZ, 0.05 * i));
+        graph.addFrame("frame_" + std::to_string(i), "frame_" + std::to_string(i - 1), edges.back());
+    }
+    const FrameGraph::FrameId leaf = graph.id("frame_" + std::to_string(kChainLength));
+    const FrameGraph::FrameId root = graph.id("frame_0");
+    const FrameGraph::FrameId middle = graph.id("frame_" + std::to_string(kChainLength / 2));
+
+    reporter.Run("manual compose chain of " + std::to_string(kChainLength), [&]() {
+        Isometry composed = edges.front();
+        for (size_t i = 1; i < edges.size(); ++i) {
+            composed = composed * edges[i];
+        }
+        benchmark::DoNotOptimize(composed);
+    });
+    reporter.Run("FrameGraph::transform cached (ids)", [&]() {
+        benchmark::DoNotOptimize(graph.transform(leaf, root));
+    });
+    const std::string leaf_name = graph.name(leaf);
+    reporter.Run("FrameGraph::transform cached (names)", [&]() {
+        benchmark::DoNotOptimize(graph.transform(leaf_name, "frame_0"));
+    });
+    // Every iteration invalidates the lower half of the chain and recomposes it.
+    reporter.Run("FrameGraph::transform after mid-chain update", [&]() {
+        graph.setTransform(middle, edges[kChainLength / 2 - 1]);
+        benchmark::DoNotOptimize(graph.transform(leaf, root));
+    });
+}
+
+}  // namespace
+}  // namespace math
+}  // namespace ekumen
+
+int main(int argc, char **argv) {
+    ekumen::benchmark::Reporter reporter(ekumen::benchmark::ParseOptions(argc, argv, ekumen::math::kDefaultIterations));
+    ekumen::math::RunFrameGraphBenchmarks(reporter);
+    return reporter.Finish();
+}
@@ -0,0 +1,265 @@
+// Micro benchmarks for ekumen::math. Each case reports time, allocations and
+// allocated bytes per operation.
+#include "isometry.h"
+#include "quaternion.h"
+#include "transform_kernels.h"
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "benchmark.h"
+
+namespace ekumen {
+namespace math {
+namespace {
+
+constexpr uint64_t kDefaultIterations{10000000};
+constexpr size_t kBatchSize{100000};
+// Large enough to spill out of the caches, so kernels become memory bound.
+constexpr size_t kLargeBatchSize{4000000};
+
+void RunVector3Benchmarks(benchmark::Reporter& reporter) {
+    Vector3 p{1., 2., 3.};
+    Vector3 q{4., 5., 6.};
+    reporter.Run("Vector3::operator+", [&]() {
+        benchmark::MakeOpaque(p);
+        benchmark::MakeOpaque(q);
+        benchmark::DoNotOptimize(p + q);
+    });
+    reporter.Run("Vector3::operator-", [&]() {
+        benchmark::MakeOpaque(p);
+        benchmark::MakeOpaque(q);
+        benchmark::DoNotOptimize(p - q);
+    });
+    reporter.Run("Vector3::operator*(double)", [&]() {
+        benchmark::MakeOpaque(p);
+        benchmark::DoNotOptimize(p * 2.);
+    });
+    reporter.Run("Vector3::operator*(Vector3)", [&]() {
+        benchmark::MakeOpaque(p);
+        benchmark::MakeOpaque(q);
+        benchmark::DoNotOptimize(p * q);
+    });
+    reporter.Run("Vector3::operator/(double)", [&]() {
+        benchmark::MakeOpaque(p);
+        benchmark::DoNotOptimize(p / 2.);
+    });
+    reporter.Run("Vector3::dot", [&]() {
+        benchmark::MakeOpaque(p);
+        benchmark::MakeOpaque(q);
+        benchmark::DoNotOptimize(p.dot(q));
+    });
+    reporter.Run("Vector3::cross", [&]() {
+        benchmark::MakeOpaque(p);
+        benchmark::MakeOpaque(q);
+        benchmark::DoNotOptimize(p.cross(q));
+    });
+    reporter.Run("Vector3::norm", [&]() {
+        benchmark::MakeOpaque(p);
+        benchmark::DoNotOptimize(p.norm());
+    });
+    Vector3 accumulator;
+    reporter.Run("Vector3::operator+=", [&]() {
+        benchmark::MakeOpaque(p);
+        accumulator += p;
+        benchmark::DoNotOptimize(accumulator);
+    });
+    reporter.Run("Vector3 copy", [&]() {
+        benchmark::MakeOpaque(p);
+        Vector3 copy(p);
+        benchmark::DoNotOptimize(copy);
+    });
+
+    // Generic code over components, the way loops without named accessors are written.
+    std::vector<Vector3> a(kBatchSize, p);
+    std::vector<Vector3> b(kBatchSize, q);
+    reporter.RunBatch("Vector3::operator[] axpy batch", kBatchSize, [&]() {
+        for (size_t k = 0; k < kBatchSize; ++k) {
+            for (int i = 0; i < 3; ++i) {
+                a[k][i] = 0.5 * a[k][i] + b[k][i];
+            }
+        }
+        benchmark::DoNotOptimize(a.front());
+    });
+    // Component picked at run time, e.g. the axis of a k-d tree split.
+    std::vector<int> axes(kBatchSize);
+    for (size_t k = 0; k < kBatchSize; ++k) {
+        axes[k] = static_cast<int>(((k * 2654435761u) >> 7) % 3);
+    }
+    reporter.RunBatch("Vector3::operator[] runtime index batch", kBatchSize, [&]() {
+        double sum{0.};
+        for (size_t k = 0; k < kBatchSize; ++k) {
+            sum += a[k][axes[k]];
+        }
+        benchmark::DoNotOptimize(sum);
+    });
+}
+
+void RunMatrix3Benchmarks(benchmark::Reporter& reporter) {
+    Matrix3 m1{1., 2., 3., 4., 5., 6., 7., 8., 10.};
+    Matrix3 m2{Isometry::RotateAround(Vector3::kUnitZ, 0.5).rotation()};
+    Vector3 p{1., 2., 3.};
+    reporter.Run("Matrix3::operator*(Matrix3)", [&]() {
+        benchmark::MakeOpaque(m1);
+        benchmark::MakeOpaque(m2);
+        benchmark::DoNotOptimize(m1 * m2);
+    });
+    reporter.Run("Matrix3::operator*(Vector3)", [&]() {
+        benchmark::MakeOpaque(p);
+        benchmark::MakeOpaque(m1);
+        benchmark::DoNotOptimize(m1 * p);
+    });
+    reporter.Run("Matrix3::det", [&]() {
+        benchmark::MakeOpaque(m1);
+        benchmark::DoNotOptimize(m1.det());
+    });
+    reporter.Run("Matrix3::inverse", [&]() {
+        benchmark::MakeOpaque(m1);
+        benchmark::DoNotOptimize(m1.inverse());
+    });
+    reporter.Run("Matrix3::tryInverse", [&]() {
+        benchmark::MakeOpaque(m1);
+        benchmark::DoNotOptimize(m1.tryInverse());
+    });
+    // Cost of a degenerate matrix: unwinding from inverse() against checking the status.
+    Matrix3 singular{Matrix3::kOnes};
+    reporter.Run("Matrix3::inverse singular catch", [&]() {
+        benchmark::MakeOpaque(singular);
+        try {
+            benchmark::DoNotOptimize(singular.inverse());
+        } catch (const std::domain_error&) {
+            benchmark::DoNotOptimize(singular);
+        }
+    });
+    reporter.Run("Matrix3::tryInverse singular", [&]() {
+        benchmark::MakeOpaque(singular);
+        benchmark::DoNotOptimize(singular.tryInverse());
+    });
+    reporter.Run("Matrix3::operator[] product loop", [&]() {
+        benchmark::MakeOpaque(m1);
+        benchmark::MakeOpaque(m2);
+        Matrix3 result;
+        for (uint32_t i = 0; i < 3; ++i) {
+            for (int j = 0; j < 3; ++j) {
+                for (uint32_t k = 0; k < 3; ++k) {
+                    result[i][j] += m1[i][k] * m2[k][j];
+                }
+            }
+        }
+        benchmark::DoNotOptimize(result);
+    });
+}
+
+void RunIsometryBenchmarks(benchmark::Reporter& reporter) {
+    Isometry t1{Vector3{1., 2., 3.}, Matrix3::kIdentity};
+    Isometry t2{Vector3{-1., 0.5, 2.}, Isometry::RotateAround(Vector3::kUnitZ, 0.5).rotation()};
+    Vector3 p{1., 2., 3.};
+    reporter.Run("Isometry::operator*(Isometry)", [&]() {
+        benchmark::MakeOpaque(t1);
+        benchmark::MakeOpaque(t2);
+        benchmark::DoNotOptimize(t1 * t2);
+    });
+    reporter.Run("Isometry::compose", [&]() {
+        benchmark::MakeOpaque(t1);
+        benchmark::MakeOpaque(t2);
+        benchmark::DoNotOptimize(t1.compose(t2));
+    });
+    reporter.Run("Isometry::inverse", [&]() {
+        benchmark::MakeOpaque(t2);
+        benchmark::DoNotOptimize(t2.inverse());
+    });
+    reporter.Run("Isometry::transform", [&]() {
+        benchmark::MakeOpaque(p);
+        benchmark::MakeOpaque(t2);
+        benchmark::DoNotOptimize(t2.transform(p));
+    });
+    reporter.Run("Isometry::operator*(Vector3)", [&]() {
+        benchmark::MakeOpaque(p);
+        benchmark::MakeOpaque(t2);
+        benchmark::DoNotOptimize(t2 * p);
+    });
+
+    std::vector<Vector3> points(kBatchSize, p);
+    reporter.RunBatch("Isometry::transform AoS batch", kBatchSize, [&]() {
+        t2.transform(points.data(), points.data(), points.size());
+        benchmark::DoNotOptimize(points.front());
+    });
+    std::vector<double> x(kBatchSize, p.x());
+    std::vector<double> y(kBatchSize, p.y());
+    std::vector<double> z(kBatchSize, p.z());
+    reporter.RunBatch("Isometry::transform SoA batch", kBatchSize, [&]() {
+        t2.transform(x.data(), y.data(), z.data(), x.data(), y.data(), z.data(), kBatchSize);
+        benchmark::DoNotOptimize(x.front());
+    });
+}
+
+void RunQuaternionIsometryBenchmarks(benchmark::Reporter& reporter) {
+    QuaternionIsometry q1{Vector3{1., 2., 3.}, Quaternion()};
+    QuaternionIsometry q2{Vector3{-1., 0.5, 2.}, Quaternion::FromAxisAngle(Vector3::kUnitZ, 0.5)};
+    Vector3 p{1., 2., 3.};
+    reporter.Run("QuaternionIsometry::operator*(QuaternionIsometry)", [&]() {
+        benchmark::MakeOpaque(q1);
+        benchmark::MakeOpaque(q2);
+        benchmark::DoNotOptimize(q1 * q2);
+    });
+    reporter.Run("QuaternionIsometry::inverse", [&]() {
+        benchmark::MakeOpaque(q2);
+        benchmark::DoNotOptimize(q2.inverse());
+    });
+    reporter.Run("QuaternionIsometry::transform", [&]() {
+        benchmark::MakeOpaque(p);
+        benchmark::MakeOpaque(q2);
+        benchmark::DoNotOptimize(q2.transform(p));
+    });
+}
+
+void RunTransformKernelBenchmarks(benchmark::Reporter& reporter) {
+    const double rotation[9]{0.36, 0.48, -0.8, -0.8, 0.6, 0., 0.48, 0.64, 0.6};
+    const double translation[3]{1.5, -2.25, 3.125};
+    std::vector<double> x(kLargeBatchSize, 1.);
+    std::vector<double> y(kLargeBatchSize, 2.);
+    std::vector<double> z(kLargeBatchSize, 3.);
+    for (const SimdLevel level : {SimdLevel::kScalar, SimdLevel::kSse42, SimdLevel::kAvx2, SimdLevel::kNeon}) {
+        if (!IsSupported(level)) {
+            continue;
+        }
+        reporter.RunBatch(std::string("TransformSoA large cloud ") + ToString(level), kLargeBatchSize, [&]() {
+            TransformSoA(level, rotation, translation, x.data(), y.data(), z.data(), x.data(), y.data(), z.data(),
+                         kLargeBatchSize);
+            benchmark::DoNotOptimize(x.front());
+        });
+    }
+
+    // Same cloud in single precision: half the memory traffic, twice the lanes per register.
+    const float rotation_f[9]{0.36f, 0.48f, -0.8f, -0.8f, 0.6f, 0.f, 0.48f, 0.64f, 0.6f};
+    const float translation_f[3]{1.5f, -2.25f, 3.125f};
+    std::vector<float> x_f(kLargeBatchSize, 1.f);
+    std::vector<float> y_f(kLargeBatchSize, 2.f);
+    std::vector<float> z_f(kLargeBatchSize, 3.f);
+    for (const SimdLevel level : {SimdLevel::kScalar, SimdLevel::kSse42, SimdLevel::kAvx2, SimdLevel::kNeon}) {
+        if (!IsSupported(level)) {
+            continue;
+        }
+        reporter.RunBatch(std::string("TransformSoA large cloud float ") + ToString(level), kLargeBatchSize, [&]() {
+            TransformSoA(level, rotation_f, translation_f, x_f.data(), y_f.data(), z_f.data(), x_f.data(), y_f.data(),
+                         z_f.data(), kLargeBatchSize);
+            benchmark::DoNotOptimize(x_f.front());
+        });
+    }
+}
+
+}  // namespace
+}  // namespace math
+}  // namespace ekumen
+
+int main(int argc, char **argv) {
+    ekumen::benchmark::Reporter reporter(ekumen::benchmark::ParseOptions(argc, argv, ekumen::math::kDefaultIterations));
+    ekumen::math::RunVector3Benchmarks(reporter);
+    ekumen::math::RunMatrix3Benchmarks(reporter);
+    ekumen::math::RunIsometryBenchmarks(reporter);
+    ekumen::math::RunQuaternionIsometryBenchmarks(reporter);
+    ekumen::math::RunTransformKernelBenchmarks(reporter);
+    return reporter.Finish();
+}
@@ -0,0 +1,86 @@
+// Benchmarks the SE(3) exponential and logarithm maps and screw interpolation.
+#include "lie.h"
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "benchmark.h"
+
+namespace ekumen {
+namespace math {
+namespace {
+
+constexpr uint64_t kDefaultIterations{1000000};
+constexpr size_t kBatchSize{4096};
+
+// Twists with angles up to |max_angle|.
+template <class T>
+std::vector<TwistT<T>> RandomTwists(unsigned seed, const T max_angle) {
+    std::mt19937 generator(seed);
+    std::uniform_real_distribution<T> distribution(-1., 1.);
+    std::uniform_real_distribution<T> angle(0., max_angle);
+    std::vector<TwistT<T>> twists(kBatchSize);
+    for (TwistT<T>& twist : twists) {
+        twist.linear = Vector3T<T>(distribution(generator), distribution(generator), distribution(generator));
+        Vector3T<T> axis(distribution(generator), distribution(generator), distribution(generator));
+        twist.angular = axis / axis.norm() * angle(generator);
+    }
+    return twists;
+}
+
+template <class T>
+void RunLieBenchmarks(benchmark::Reporter& reporter, const std::string& suffix, const T small_angle) {
+    const std::vector<TwistT<T>> twists = RandomTwists<T>(1, T(3));
+    std::vector<IsometryT<T>> isometries(kBatchSize, IsometryT<T>::FromTranslation(Vector3T<T>::kZero));
+    ExpSE3Batch(twists.data(), isometries.data(), kBatchSize);
+    std::vector<TwistT<T>> logs(kBatchSize);
+    reporter.Run("ExpSE3" + suffix, [&]() { benchmark::DoNotOptimize(ExpSE3(twists[3])); });
+    reporter.Run("LogSE3" + suffix, [&]() { benchmark::DoNotOptimize(LogSE3(isometries[3])); });
+    reporter.Run("Interpolate" + suffix,
+                 [&]() { benchmark::DoNotOptimize(Interpolate(isometries[3], isometries[4], T(0.3))); });
+    reporter.RunBatch("ExpSE3 loop" + suffix, kBatchSize, [&]() {
+        for (size_t i = 0; i < kBatchSize; ++i) {
+            isometries[i] = ExpSE3(twists[i]);
+        }
+        benchmark::DoNotOptimize(isometries.front());
+    });
+    reporter.RunBatch("ExpSE3Batch" + suffix, kBatchSize, [&]() {
+        ExpSE3Batch(twists.data(), isometries.data(), kBatchSize);
+        benchmark::DoNotOptimize(isometries.front());
+    });
+    reporter.RunBatch("LogSE3 loop" + suffix, kBatchSize, [&]() {
+        for (size_t i = 0; i < kBatchSize; ++i) {
+            logs[i] = LogSE3(isometries[i]);
+        }
+        benchmark::DoNotOptimize(logs.front());
+    });
+    reporter.RunBatch("LogSE3Batch" + suffix, kBatchSize, [&]() {
+        LogSE3Batch(isometries.data(), logs.data(), kBatchSize);
+        benchmark::DoNotOptimize(logs.front());
+    });
+
+    // Increments below the Taylor threshold, as integrators and optimizers produce them.
+    const std::vector<TwistT<T>> small = RandomTwists<T>(2, small_angle);
+    ExpSE3Batch(small.data(), isometries.data(), kBatchSize);
+    reporter.RunBatch("ExpSE3Batch small angles" + suffix, kBatchSize, [&]() {
+        ExpSE3Batch(small.data(), isometries.data(), kBatchSize);
+        benchmark::DoNotOptimize(isometries.front());
+    });
+    reporter.RunBatch("LogSE3Batch small angles" + suffix, kBatchSize, [&]() {
+        LogSE3Batch(isometries.data(), logs.data(), kBatchSize);
+        benchmark::DoNotOptimize(logs.front());
+    });
+}
+
+}  // namespace
+}  // namespace math
+}  // namespace ekumen
+
+int main(int argc, char **argv) {
+    ekumen::benchmark::Reporter reporter(ekumen::benchmark::ParseOptions(argc, argv, ekumen::math::kDefaultIterations));
+    ekumen::math::RunLieBenchmarks<double>(reporter, "", 1e-2);
+    ekumen::math::RunLieBenchmarks<float>(reporter, " float", 0.2f);
+    return reporter.Finish();
+}
@@ -0,0 +1,81 @@
+// Benchmarks the batched Matrix3 kernels against calling Matrix3::inverse() and
+// Matrix3::product() one matrix at a time.
+#include "matrix_kernels.h"
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "benchmark.h"
+
+namespace ekumen {
+namespace math {
+namespace {
+
+constexpr uint64_t kDefaultIterations{10000000};
+// Three double arrays of this many matrices stay within L2, so the kernels are compute bound.
+constexpr size_t kBatchSize{1024};
+
+template <class T>
+std::vector<Matrix3T<T>> RandomMatrices(unsigned seed) {
+    std::mt19937 generator(seed);
+    std::uniform_real_distribution<T> distribution(-10., 10.);
+    std::vector<Matrix3T<T>> matrices(kBatchSize);
+    for (Matrix3T<T>& matrix : matrices) {
+        for (uint32_t row = 0; row < 3; ++row) {
+            matrix[row] = Vector3T<T>(distribution(generator), distribution(generator), distribution(generator));
+        }
+    }
+    return matrices;
+}
+
+template <class T>
+void RunMatrixKernelBenchmarks(benchmark::Reporter& reporter, const std::string& suffix) {
+    const std::vector<Matrix3T<T>> a = RandomMatrices<T>(1);
+    const std::vector<Matrix3T<T>> b = RandomMatrices<T>(2);
+    std::vector<Matrix3T<T>> out(kBatchSize);
+    std::vector<uint64_t> singular(SingularMaskWords(kBatchSize));
+
+    reporter.RunBatch("Matrix3::inverse loop" + suffix, kBatchSize, [&]() {
+        for (size_t i = 0; i < kBatchSize; ++i) {
+            out[i] = a[i].inverse();
+        }
+        benchmark::DoNotOptimize(out.front());
+    });
+    for (const SimdLevel level : {SimdLevel::kScalar, SimdLevel::kSse42, SimdLevel::kAvx2, SimdLevel::kNeon}) {
+        if (!IsSupported(level)) {
+            continue;
+        }
+        reporter.RunBatch("InverseBatch" + suffix + " " + ToString(level), kBatchSize, [&]() {
+            benchmark::DoNotOptimize(InverseBatch(level, a.data(), out.data(), kBatchSize, singular.data()));
+        });
+    }
+
+    reporter.RunBatch("Matrix3::product loop" + suffix, kBatchSize, [&]() {
+        for (size_t i = 0; i < kBatchSize; ++i) {
+            out[i] = a[i].product(b[i]);
+        }
+        benchmark::DoNotOptimize(out.front());
+    });
+    for (const SimdLevel level : {SimdLevel::kScalar, SimdLevel::kSse42, SimdLevel::kAvx2, SimdLevel::kNeon}) {
+        if (!IsSupported(level)) {
+            continue;
+        }
+        reporter.RunBatch("ProductBatch" + suffix + " " + ToString(level), kBatchSize, [&]() {
+            ProductBatch(level, a.data(), b.data(), out.data(), kBatchSize);
+            benchmark::DoNotOptimize(out.front());
+        });
+    }
+}
+
+}  // namespace
+}  // namespace math
+}  // namespace ekumen
+
+int main(int argc, char **argv) {
+    ekumen::benchmark::Reporter reporter(ekumen::benchmark::ParseOptions(argc, argv, ekumen::math::kDefaultIterations));
+    ekumen::math::RunMatrixKernelBenchmarks<double>(reporter, "");
+    ekumen::math::RunMatrixKernelBenchmarks<float>(reporter, " float");
+    return reporter.Finish();
+}
@@ -0,0 +1,56 @@
+// Benchmarks whole-cloud operations on PointCloud against a std::vector<Vector3>.
+#include "point_cloud.h"
+
+#include <cstdint>
+#include <vector>
+
+#include "benchmark.h"
+
+namespace ekumen {
+namespace math {
+namespace {
+
+constexpr uint64_t kDefaultIterations{20000000};
+constexpr size_t kCloudSize{1000000};
+
+void RunPointCloudBenchmarks(benchmark::Reporter& reporter) {
+    const Isometry t{Vector3{-1., 0.5, 2.}, Isometry::RotateAround(Vector3::kUnitZ, 0.5).rotation()};
+    std::vector<Vector3> points(kCloudSize, Vector3{1., 2., 3.});
+    PointCloud cloud(kCloudSize);
+    for (auto point : cloud) {
+        point = Vector3{1., 2., 3.};
+    }
+    PointCloudf float_cloud(kCloudSize);
+    const Isometryf t_float{t};
+
+    reporter.RunBatch("std::vector<Vector3> transform", kCloudSize, [&]() {
+        t.transform(points.data(), points.data(), points.size());
+        benchmark::DoNotOptimize(points.front());
+    });
+    reporter.RunBatch("PointCloud::transform", kCloudSize, [&]() {
+        cloud.transform(t);
+        benchmark::DoNotOptimize(cloud.x()[0]);
+    });
+    reporter.RunBatch("PointCloudf::transform", kCloudSize, [&]() {
+        float_cloud.transform(t_float);
+        benchmark::DoNotOptimize(float_cloud.x()[0]);
+    });
+    reporter.RunBatch("PointCloud iterate centroid", kCloudSize, [&]() {
+        Vector3 sum;
+        const PointCloud& points_view = cloud;
+        for (const Vector3 point : points_view) {
+            sum += point;
+        }
+        benchmark::DoNotOptimize(sum);
+    });
+}
+
+}  // namespace
+}  // namespace math
+}  // namespace ekumen
+
+int main(int argc, char **argv) {
+    ekumen::benchmark::Reporter reporter(ekumen::benchmark::ParseOptions(argc, argv, ekumen::math::kDefaultIterations));
+    ekumen::math::RunPointCloudBenchmarks(reporter);
+    return reporter.Finish();
+}
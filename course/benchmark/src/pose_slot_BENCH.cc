@@ -0,0 +1,100 @@
+// Contention benchmarks for PoseSlot: one writer publishing as fast as it can while a growing
+// number of reader threads read the latest pose, against the same slot guarded by a mutex.
+#include "pose_slot.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "benchmark.h"
+
+namespace ekumen {
+namespace math {
+namespace {
+
+constexpr uint64_t kDefaultIterations{1000000};
+constexpr int kMaxReaders{64};
+
+// Runs |readers| threads that call |read| |iterations| times each while a writer thread calls
+// |write| until they are done. Reports the wall time per read, summed over all readers.
+template <class Read, class Write>
+benchmark::Result RunContention(const std::string& name, const int readers, const uint64_t iterations, Read&& read,
+                                Write&& write) {
+    std::atomic<bool> start{false};
+    std::atomic<bool> done{false};
+    std::thread writer([&]() {
+        while (!done.load(std::memory_order_relaxed)) {
+            write();
+        }
+    });
+    std::vector<std::thread> threads;
+    for (int i = 0; i < readers; ++i) {
+        threads.emplace_back([&]() {
+            while (!start.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+            for (uint64_t j = 0; j < iterations; ++j) {
+                benchmark::DoNotOptimize(read());
+            }
+        });
+    }
+    const auto begin = std::chrono::steady_clock::now();
+    start.store(true, std::memory_order_release);
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    const auto end = std::chrono::steady_clock::now();
+    done.store(true, std::memory_order_relaxed);
+    writer.join();
+    const double reads = static_cast<double>(iterations) * readers;
+    const double elapsed_ns = std::chrono::duration<double, std::nano>(end - begin).count();
+    return benchmark::Result{name, iterations * readers, elapsed_ns / reads, 0., 0.};
+}
+
+void RunPoseSlotBenchmarks(benchmark::Reporter& reporter, const uint64_t iterations) {
+    const Isometry pose_a = Isometry::FromTranslation(Vector3{1., 2., 3.});
+    const Isometry pose_b = Isometry::RotateAround(Vector3::kUnitZ, 0.5);
+    PoseSlot slot(pose_a);
+    bool flip{false};
+    std::mutex mutex;
+    Isometry guarded = pose_a;
+
+    reporter.Run("PoseSlot::read uncontended", [&]() { benchmark::DoNotOptimize(slot.read()); });
+    reporter.Run("PoseSlot::publish uncontended", [&]() { slot.publish(pose_b); });
+    for (int readers = 1; readers <= kMaxReaders; readers *= 2) {
+        // Keeps the total amount of work constant as the reader count grows.
+        const uint64_t per_reader = iterations / readers > 0 ? iterations / readers : 1;
+        reporter.Add(RunContention("PoseSlot::read " + std::to_string(readers) + " readers", readers, per_reader,
+                                   [&]() { return slot.read(); },
+                                   [&]() {
+                                       flip = !flip;
+                                       slot.publish(flip ? pose_a : pose_b);
+                                   }));
+        reporter.Add(RunContention("std::mutex read " + std::to_string(readers) + " readers", readers, per_reader,
+                                   [&]() {
+                                       std::lock_guard<std::mutex> lock(mutex);
+                                       return guarded;
+                                   },
+                                   [&]() {
+                                       std::lock_guard<std::mutex> lock(mutex);
+                                       flip = !flip;
+                                       guarded = flip ? pose_a : pose_b;
+                                   }));
+    }
+}
+
+}  // namespace
+}  // namespace math
+}  // namespace ekumen
+
+int main(int argc, char **argv) {
+    const ekumen::benchmark::Options options =
+        ekumen::benchmark::ParseOptions(argc, argv, ekumen::math::kDefaultIterations);
+    ekumen::benchmark::Reporter reporter(options);
+    ekumen::math::RunPoseSlotBenchmarks(reporter, options.iterations);
+    return reporter.Finish();
+}
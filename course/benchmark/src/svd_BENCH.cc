@@ -0,0 +1,73 @@
+// Benchmarks the 3x3 SVD, the polar decomposition and Isometry::normalize().
+#include "svd.h"
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "benchmark.h"
+
+namespace ekumen {
+namespace math {
+namespace {
+
+constexpr uint64_t kDefaultIterations{1000000};
+constexpr size_t kBatchSize{4096};
+
+template <class T>
+std::vector<Matrix3T<T>> RandomMatrices(unsigned seed) {
+    std::mt19937 generator(seed);
+    std::uniform_real_distribution<T> distribution(-1., 1.);
+    std::vector<Matrix3T<T>> matrices(kBatchSize);
+    for (Matrix3T<T>& matrix : matrices) {
+        for (uint32_t row = 0; row < 3; ++row) {
+            matrix[row] = Vector3T<T>(distribution(generator), distribution(generator), distribution(generator));
+        }
+    }
+    return matrices;
+}
+
+template <class T>
+void RunSvdBenchmarks(benchmark::Reporter& reporter, const std::string& suffix) {
+    const std::vector<Matrix3T<T>> matrices = RandomMatrices<T>(1);
+    std::vector<SvdT<T>> out(kBatchSize);
+    reporter.Run("ComputeSvd" + suffix, [&]() { benchmark::DoNotOptimize(ComputeSvd(matrices[3])); });
+    reporter.Run("PolarDecompose" + suffix, [&]() { benchmark::DoNotOptimize(PolarDecompose(matrices[3])); });
+    reporter.Run("NearestRotation" + suffix, [&]() { benchmark::DoNotOptimize(NearestRotation(matrices[3])); });
+    reporter.RunBatch("ComputeSvd loop" + suffix, kBatchSize, [&]() {
+        for (size_t i = 0; i < kBatchSize; ++i) {
+            out[i] = ComputeSvd(matrices[i]);
+        }
+        benchmark::DoNotOptimize(out.front());
+    });
+    reporter.RunBatch("ComputeSvdBatch" + suffix, kBatchSize, [&]() {
+        ComputeSvdBatch(matrices.data(), out.data(), kBatchSize);
+        benchmark::DoNotOptimize(out.front());
+    });
+}
+
+void RunNormalizeBenchmarks(benchmark::Reporter& reporter) {
+    const Isometry step = Isometry::RotateAround(Vector3(1., 2., 2.) / 3., 1e-3);
+    Isometry pose = Isometry::FromTranslation(Vector3(1., 2., 3.));
+    reporter.Run("Isometry::operator*(Isometry)", [&]() {
+        pose = pose * step;
+        benchmark::DoNotOptimize(pose);
+    });
+    reporter.Run("Isometry::normalize", [&]() {
+        pose.normalize();
+        benchmark::DoNotOptimize(pose);
+    });
+}
+
+}  // namespace
+}  // namespace math
+}  // namespace ekumen
+
+int main(int argc, char **argv) {
+    ekumen::benchmark::Reporter reporter(ekumen::benchmark::ParseOptions(argc, argv, ekumen::math::kDefaultIterations));
+    ekumen::math::RunSvdBenchmarks<double>(reporter, "");
+    ekumen::math::RunSvdBenchmarks<float>(reporter, " float");
+    ekumen::math::RunNormalizeBenchmarks(reporter);
+    return reporter.Finish();
+}
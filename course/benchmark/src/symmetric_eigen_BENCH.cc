@@ -0,0 +1,62 @@
+// Benchmarks the symmetric eigen-solver on random covariance matrices.
+#include "symmetric_eigen.h"
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "benchmark.h"
+
+namespace ekumen {
+namespace math {
+namespace {
+
+constexpr uint64_t kDefaultIterations{1000000};
+constexpr size_t kBatchSize{4096};
+
+// Covariances of small random neighborhoods, as normal estimation computes them.
+template <class T>
+std::vector<Matrix3T<T>> RandomCovariances(unsigned seed) {
+    std::mt19937 generator(seed);
+    std::normal_distribution<T> distribution(0., 1.);
+    std::vector<Matrix3T<T>> covariances(kBatchSize);
+    for (Matrix3T<T>& covariance : covariances) {
+        for (int i = 0; i < 16; ++i) {
+            const Vector3T<T> point(distribution(generator), distribution(generator),
+                                    T(0.01) * distribution(generator));
+            for (uint32_t row = 0; row < 3; ++row) {
+                covariance[row] += point * point[row];
+            }
+        }
+    }
+    return covariances;
+}
+
+template <class T>
+void RunSymmetricEigenBenchmarks(benchmark::Reporter& reporter, const std::string& suffix) {
+    const std::vector<Matrix3T<T>> covariances = RandomCovariances<T>(1);
+    std::vector<EigenDecompositionT<T>> out(kBatchSize);
+    reporter.Run("EigenDecompose" + suffix, [&]() { benchmark::DoNotOptimize(EigenDecompose(covariances[7])); });
+    reporter.RunBatch("EigenDecompose loop" + suffix, kBatchSize, [&]() {
+        for (size_t i = 0; i < kBatchSize; ++i) {
+            out[i] = EigenDecompose(covariances[i]);
+        }
+        benchmark::DoNotOptimize(out.front());
+    });
+    reporter.RunBatch("EigenDecomposeBatch" + suffix, kBatchSize, [&]() {
+        EigenDecomposeBatch(covariances.data(), out.data(), kBatchSize);
+        benchmark::DoNotOptimize(out.front());
+    });
+}
+
+}  // namespace
+}  // namespace math
+}  // namespace ekumen
+
+int main(int argc, char **argv) {
+    ekumen::benchmark::Reporter reporter(ekumen::benchmark::ParseOptions(argc, argv, ekumen::math::kDefaultIterations));
+    ekumen::math::RunSymmetricEigenBenchmarks<double>(reporter, "");
+    ekumen::math::RunSymmetricEigenBenchmarks<float>(reporter, " float");
+    return reporter.Finish();
+}
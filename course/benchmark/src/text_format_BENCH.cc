@@ -0,0 +1,156 @@
+// Benchmarks the text formatter and parser against stream and C library conversions.
+#include "text_format.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "benchmark.h"
+#include "isometry.h"
+
+namespace ekumen {
+namespace math {
+namespace {
+
+constexpr uint64_t kDefaultIterations{100000};
+constexpr size_t kValues{1024};
+constexpr size_t kPoses{1024};
+
+std::vector<double> MakeValues() {
+    std::mt19937_64 generator(7);
+    std::uniform_real_distribution<double> distribution(-100., 100.);
+    std::vector<double> values;
+    for (size_t i = 0; i < kValues; ++i) {
+        values.push_back(distribution(generator));
+    }
+    return values;
+}
+
+std::vector<std::string> FormatAll(const std::vector<double>& values) {
+    std::vector<std::string> texts;
+    char buffer[kMaxScalarChars];
+    for (const double value : values) {
+        texts.emplace_back(buffer, FormatScalar(value, buffer));
+    }
+    return texts;
+}
+
+void RunScalarBenchmarks(benchmark::Reporter& reporter) {
+    const std::vector<double> values = MakeValues();
+    char buffer[64];
+    reporter.RunBatch("ostream<< setprecision(17) double", kValues, [&]() {
+        std::ostringstream stream;
+        stream << std::setprecision(17);
+        for (const double value : values) {
+            stream << value << ' ';
+        }
+        benchmark::DoNotOptimize(stream.tellp());
+    });
+    reporter.RunBatch("snprintf %.17g double", kValues, [&]() {
+        for (const double value : values) {
+            benchmark::DoNotOptimize(std::snprintf(buffer, sizeof(buffer), "%.17g", value));
+        }
+    });
+    reporter.RunBatch("FormatScalar double", kValues, [&]() {
+        for (const double value : values) {
+            benchmark::DoNotOptimize(FormatScalar(value, buffer));
+        }
+    });
+
+    // Shortest texts are mostly 15 to 17 digits, past the fast path. Texts with few digits,
+    // like hand written configuration, take it.
+    const std::vector<std::string> long_texts = FormatAll(values);
+    std::vector<std::string> short_texts;
+    for (const double value : values) {
+        std::snprintf(buffer, sizeof(buffer), "%.4f", value);
+        short_texts.push_back(buffer);
+    }
+    const std::vector<std::pair<std::string, const std::vector<std::string>*>> inputs{
+        {"shortest", &long_texts}, {"4 decimals", &short_texts}};
+    for (const auto& input : inputs) {
+        const std::vector<std::string>& texts = *input.second;
+        reporter.RunBatch("istream>> double, " + input.first, kValues, [&]() {
+            double value;
+            for (const std::string& text : texts) {
+                std::istringstream stream(text);
+                stream >> value;
+                benchmark::DoNotOptimize(value);
+            }
+        });
+        reporter.RunBatch("strtod, " + input.first, kValues, [&]() {
+            for (const std::string& text : texts) {
+                benchmark::DoNotOptimize(std::strtod(text.c_str(), nullptr));
+            }
+        });
+        reporter.RunBatch("ParseScalar double, " + input.first, kValues, [&]() {
+            double value;
+            for (const std::string& text : texts) {
+                benchmark::DoNotOptimize(ParseScalar(text.data(), text.data() + text.size(), &value));
+                benchmark::DoNotOptimize(value);
+            }
+        });
+    }
+}
+
+void RunIsometryBenchmarks(benchmark::Reporter& reporter) {
+    std::vector<Isometry> poses;
+    for (size_t i = 0; i < kPoses; ++i) {
+        poses.push_back(Isometry::FromTranslation(Vector3{0.01 * i, 2., 3.}) *
+                        Isometry::RotateAround(Vector3::kUnitZ, 1e-3 * i));
+    }
+    // What a lossless printer looks like on top of iostreams.
+    reporter.RunBatch("ostream setprecision(17) Isometry", kPoses, [&]() {
+        std::ostringstream stream;
+        stream << std::setprecision(17);
+        for (const Isometry& pose : poses) {
+            const Vector3& t = pose.translation();
+            const Matrix3& r = pose.rotation();
+            stream << "[T: (x: " << t.x() << ", y: " << t.y() << ", z: " << t.z() << "), R:[[" << r[0][0] << ", "
+                   << r[0][1] << ", " << r[0][2] << "], [" << r[1][0] << ", " << r[1][1] << ", " << r[1][2]
+                   << "], [" << r[2][0] << ", " << r[2][1] << ", " << r[2][2] << "]]]\n";
+        }
+        benchmark::DoNotOptimize(stream.tellp());
+    });
+    reporter.RunBatch("operator<< Isometry", kPoses, [&]() {
+        std::ostringstream stream;
+        for (const Isometry& pose : poses) {
+            stream << pose << '\n';
+        }
+        benchmark::DoNotOptimize(stream.tellp());
+    });
+    std::vector<char> text(kPoses * (kMaxIsometryChars + 1));
+    char* end = text.data();
+    reporter.RunBatch("Format(Isometry)", kPoses, [&]() {
+        end = text.data();
+        for (const Isometry& pose : poses) {
+            end = Format(pose, end);
+            *end++ = '\n';
+        }
+        benchmark::DoNotOptimize(end);
+    });
+    Isometry parsed = Isometry::FromTranslation(Vector3::kZero);
+    reporter.RunBatch("Parse(Isometry)", kPoses, [&]() {
+        const char* p = text.data();
+        while (p != nullptr && p != end) {
+            p = Parse(p, end, &parsed);
+            benchmark::DoNotOptimize(parsed);
+            p = p == nullptr ? nullptr : p + 1;
+        }
+    });
+}
+
+}  // namespace
+}  // namespace math
+}  // namespace ekumen
+
+int main(int argc, char **argv) {
+    ekumen::benchmark::Reporter reporter(ekumen::benchmark::ParseOptions(argc, argv, ekumen::math::kDefaultIterations));
+    ekumen::math::RunScalarBenchmarks(reporter);
+    ekumen::math::RunIsometryBenchmarks(reporter);
+    return reporter.Finish();
+}
@@ -0,0 +1,46 @@
+// Benchmarks integrating a long odometry chain serially and with the parallel prefix scan.
+#include "trajectory.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "benchmark.h"
+
+namespace ekumen {
+namespace math {
+namespace {
+
+constexpr uint64_t kDefaultIterations{4000000};
+constexpr size_t kSteps{1000000};
+
+void RunTrajectoryBenchmarks(benchmark::Reporter& reporter) {
+    std::vector<Isometry> steps;
+    steps.reserve(kSteps);
+    for (size_t i = 0; i < kSteps; ++i) {
+        steps.push_back(Isometry::FromTranslation(Vector3{0.01, 0., 0.}) *
+                        Isometry::RotateAround(Vector3::kUnitZ, i % 2 == 0 ? 1e-3 : -1e-3));
+    }
+    std::vector<Isometry> poses(kSteps, Isometry::FromTranslation(Vector3::kZero));
+    reporter.RunBatch("PrefixCompose serial 1M steps", kSteps, [&]() {
+        PrefixCompose(steps.data(), poses.data(), kSteps);
+        benchmark::DoNotOptimize(poses.back());
+    });
+    for (const size_t threads : {2u, 4u, 8u}) {
+        ThreadPool pool(threads);
+        reporter.RunBatch("PrefixCompose " + std::to_string(threads) + " threads 1M steps", kSteps, [&]() {
+            PrefixCompose(pool, steps.data(), poses.data(), kSteps);
+            benchmark::DoNotOptimize(poses.back());
+        });
+    }
+}
+
+}  // namespace
+}  // namespace math
+}  // namespace ekumen
+
+int main(int argc, char **argv) {
+    ekumen::benchmark::Reporter reporter(ekumen::benchmark::ParseOptions(argc, argv, ekumen::math::kDefaultIterations));
+    ekumen::math::RunTrajectoryBenchmarks(reporter);
+    return reporter.Finish();
+}
@@ -0,0 +1,63 @@
+// Micro benchmarks for TransformBuffer inserts and interpolated lookups.
+#include "transform_buffer.h"
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "benchmark.h"
+
+namespace ekumen {
+namespace math {
+namespace {
+
+constexpr uint64_t kDefaultIterations{1000000};
+// Ten seconds of history at 1 kHz.
+constexpr double kRate{1000.};
+constexpr double kRetention{10.};
+constexpr size_t kCapacity{10000};
+constexpr size_t kQueries{4096};
+
+Isometry PoseAt(const double stamp) {
+    return Isometry::FromTranslation(Vector3{stamp, 0.5 * stamp, 0.}) *
+           Isometry::RotateAround(Vector3::kUnitZ, 0.3 * stamp);
+}
+
+void RunTransformBufferBenchmarks(benchmark::Reporter& reporter) {
+    TransformBuffer buffer(kCapacity, kRetention);
+    double stamp{0.};
+    for (size_t i = 0; i < kCapacity; ++i, stamp += 1. / kRate) {
+        buffer.insert(stamp, PoseAt(stamp));
+    }
+
+    // Query stamps are drawn up front so that the generator stays out of the timed loop.
+    std::mt19937 generator(7);
+    std::uniform_real_distribution<double> distribution(buffer.oldest(), buffer.newest());
+    std::vector<double> queries(kQueries);
+    for (double& query : queries) {
+        query = distribution(generator);
+    }
+    size_t next{0};
+    reporter.Run("TransformBuffer::lookup 10k samples", [&]() {
+        benchmark::DoNotOptimize(buffer.lookup(queries[next++ % kQueries]));
+    });
+    reporter.Run("TransformBuffer::lookupQuaternion 10k samples", [&]() {
+        benchmark::DoNotOptimize(buffer.lookupQuaternion(queries[next++ % kQueries]));
+    });
+
+    const Isometry pose = PoseAt(1.);
+    reporter.Run("TransformBuffer::insert full buffer", [&]() {
+        buffer.insert(stamp, pose);
+        stamp += 1. / kRate;
+    });
+}
+
+}  // namespace
+}  // namespace math
+}  // namespace ekumen
+
+int main(int argc, char **argv) {
+    ekumen::benchmark::Reporter reporter(ekumen::benchmark::ParseOptions(argc, argv, ekumen::math::kDefaultIterations));
+    ekumen::math::RunTransformBufferBenchmarks(reporter);
+    return reporter.Finish();
+}
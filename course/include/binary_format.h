@@ -0,0 +1,131 @@
+#pragma once
+
+// Standard libraries
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+#include "isometry.h"
+#include "point_cloud.h"
+
+namespace ekumen {
+namespace math {
+
+// Binary files for trajectories and point clouds.
+//
+// Every file starts with a 64 byte header: the magic "EKUMATH\0", then little-endian uint32
+// format version, content kind, scalar size in bytes and attribute flags, then a uint64 record
+// count, and zero padding. Values are stored exactly as in memory (little-endian IEEE 754), so
+// a round trip is lossless and a mapped file can be used in place.
+//
+// Trajectories follow the header as fixed size records of twelve doubles: the rotation in
+// row-major order, then the translation. Pose N starts at byte 64 + 96 * N.
+//
+// Point clouds store the x, y and z arrays, then the intensity (float) and timestamp (double)
+// arrays if present, each starting on a 64 byte boundary.
+//
+// Readers map the file and check the header, throwing std::runtime_error if the file cannot be
+// opened or is not a valid file of the expected kind and version.
+constexpr uint32_t kBinaryFormatVersion{1};
+
+// Streams poses to a trajectory file, so trajectories larger than memory can be written.
+class TrajectoryWriter {
+    public:
+        // Creates or truncates |path|. Throws std::runtime_error on failure.
+        explicit TrajectoryWriter(const std::string& path);
+        // Closes the file if close() was not called, ignoring errors.
+        ~TrajectoryWriter();
+
+        TrajectoryWriter(const TrajectoryWriter&) = delete;
+        TrajectoryWriter& operator=(const TrajectoryWriter&) = delete;
+
+        void append(const Isometry& pose);
+        void append(const Isometry* poses, size_t count);
+        size_t size() const { return count_; };
+        // Writes the final pose count into the header and closes the file. Throws
+        // std::runtime_error if any write failed.
+        void close();
+
+    private:
+        std::FILE* file_;
+        uint64_t count_{0};
+        bool failed_{false};
+};
+
+// Read-only memory mapping of a whole file.
+class MappedFile {
+    public:
+        // Throws std::runtime_error if |path| cannot be opened or mapped.
+        explicit MappedFile(const std::string& path);
+        ~MappedFile();
+
+        MappedFile(MappedFile&& other);
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+        MappedFile& operator=(MappedFile&&) = delete;
+
+        const uint8_t* data() const { return data_; };
+        size_t size() const { return size_; };
+
+    private:
+        const uint8_t* data_;
+        size_t size_;
+};
+
+// Zero-copy view of a trajectory file. Poses are read straight from the mapping.
+class TrajectoryReader {
+    public:
+        explicit TrajectoryReader(const std::string& path);
+
+        size_t size() const { return count_; };
+        // Returns pose |index| without touching the ones before it. Throws std::out_of_range if
+        // |index| is not below size(), and std::runtime_error if the stored pose is not finite
+        // or its rotation is not orthonormal within Isometry::kOrthonormalTolerance.
+        Isometry pose(size_t index) const;
+        // Twelve doubles per pose, see the format description above.
+        const double* data() const { return records_; };
+
+    private:
+        MappedFile file_;
+        size_t count_;
+        const double* records_;
+};
+
+// Writes |cloud| to |path|, replacing it. Throws std::runtime_error on failure.
+template <class T>
+void WritePointCloud(const std::string& path, const PointCloudT<T>& cloud);
+
+// Zero-copy view of a point cloud file of scalar type |T|.
+template <class T>
+class PointCloudReaderT {
+    public:
+        explicit PointCloudReaderT(const std::string& path);
+
+        size_t size() const { return count_; };
+        const T* x() const { return x_; };
+        const T* y() const { return y_; };
+        const T* z() const { return z_; };
+        // Null when the file has no such attribute.
+        const float* intensity() const { return intensity_; };
+        const double* timestamp() const { return timestamp_; };
+        Vector3T<T> operator[](size_t index) const { return Vector3T<T>(x_[index], y_[index], z_[index]); };
+
+        // Copies the file into a new cloud.
+        PointCloudT<T> toPointCloud() const;
+
+    private:
+        MappedFile file_;
+        size_t count_;
+        const T* x_;
+        const T* y_;
+        const T* z_;
+        const float* intensity_{nullptr};
+        const double* timestamp_{nullptr};
+};
+
+using PointCloudReader = PointCloudReaderT<double>;
+using PointCloudfReader = PointCloudReaderT<float>;
+
+}  // namespace math
+}  // namespace ekumen
@@ -0,0 +1,96 @@
+#pragma once
+
+// Standard libraries
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "isometry.h"
+
+namespace ekumen {
+namespace math {
+
+// Tree of named coordinate frames linked by rigid transforms, e.g.
+// world -> map -> odom -> base -> sensor.
+//
+// Every frame caches its transform relative to the root of its tree, and transform() caches
+// the result for each (source, target) pair it answers, so repeated lookups are a hash hit.
+// Changing an edge invalidates only the frames below it. Lookups update the caches, so the
+// graph must not be shared between threads without external locking.
+class FrameGraph {
+    public:
+        using FrameId = size_t;
+
+        // Registers |name| as the root of a new tree. Throws std::invalid_argument if a frame
+        // with that name already exists.
+        FrameId addFrame(const std::string& name);
+        // Registers |name| as a child of |parent|. |parent_to_frame| maps points expressed in
+        // the new frame into |parent|. Throws std::invalid_argument if |name| already exists
+        // and std::out_of_range if |parent| does not.
+        FrameId addFrame(const std::string& name, const std::string& parent, const Isometry& parent_to_frame);
+
+        // Replaces the transform from the parent of |name| to |name|. Throws std::out_of_range
+        // if |name| is unknown and std::invalid_argument if it is a root.
+        void setTransform(const std::string& name, const Isometry& parent_to_frame);
+        void setTransform(FrameId id, const Isometry& parent_to_frame);
+
+        // Returns the transform mapping points expressed in |source| into |target|. Throws
+        // std::out_of_range for unknown frames and std::invalid_argument if both frames do not
+        // share a root.
+        Isometry transform(const std::string& source, const std::string& target) const;
+        Isometry transform(FrameId source, FrameId target) const;
+
+        // Returns the id of |name|. Resolving names once and querying by id skips the string
+        // hashing. Throws std::out_of_range if |name| is unknown.
+        FrameId id(const std::string& name) const;
+        bool hasFrame(const std::string& name) const { return ids_.count(name) != 0; };
+        const std::string& name(FrameId id) const { return frame(id).name; };
+        // Returns the parent of |name|, or an empty string for a root.
+        const std::string& parent(const std::string& name) const;
+        size_t size() const { return frames_.size(); };
+
+    private:
+        static constexpr FrameId kNoParent{static_cast<FrameId>(-1)};
+
+        struct Frame {
+            Frame(const std::string& name, FrameId parent, FrameId root, const Isometry& parent_to_frame)
+                : name(name), parent(parent), root(root), parent_to_frame(parent_to_frame),
+                  root_to_frame(parent_to_frame) {};
+
+            std::string name;
+            FrameId parent;
+            FrameId root;
+            std::vector<FrameId> children;
+            Isometry parent_to_frame;
+            // Valid only while |cached| is set.
+            Isometry root_to_frame;
+            bool cached{false};
+            // Bumped whenever |root_to_frame| is invalidated. Pair cache entries remember the
+            // versions they were computed from.
+            uint64_t version{0};
+        };
+
+        struct PairEntry {
+            uint64_t source_version;
+            uint64_t target_version;
+            Isometry target_to_source;
+        };
+
+        // Throws std::out_of_range if |id| is unknown.
+        Frame& frame(FrameId id) const;
+        FrameId addFrame(const std::string& name, FrameId parent, const Isometry& parent_to_frame);
+        void invalidate(FrameId id);
+        const Isometry& rootTransform(FrameId id) const;
+
+        // Root transforms and the pair cache are filled lazily by const lookups.
+        mutable std::vector<Frame> frames_;
+        std::unordered_map<std::string, FrameId> ids_;
+        mutable std::unordered_map<uint64_t, PairEntry> pairs_;
+        // Reused by the tree walks so that updates and cache misses do not allocate.
+        mutable std::vector<FrameId> scratch_;
+};
+
+}  // namespace math
+}  // namespace ekumen
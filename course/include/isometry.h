@@ -1,14 +1,19 @@
 #pragma once
 
 // Standard libraries
+#include <cassert>
 #include <cmath>
+#include <cstddef>
+#include <cstdint>
 #include <initializer_list>
 #include <iostream>
 #include <limits>
 #include <sstream>
+#include <stdexcept>
 #include <string>
 #include <vector>
-#include <iomanip>
+
+#include "text_format.h"
 
 namespace ekumen {
 namespace math {
@@ -20,208 +25,694 @@ typename std::enable_if<!std::numeric_limits<T>::is_integer, bool>::type almost_
            || std::fabs(a - b) < std::numeric_limits<T>::min();
 }
 
+// Per scalar type tolerances. almost_equal already scales by the type's epsilon, so one
+// resolution suits every type. The orthonormality check is absolute, and float rotations
+// drift past 1e-6 after a handful of compositions.
+template <class T>
+struct ScalarTraits;
+
+template <>
+struct ScalarTraits<double> {
+    static constexpr int kResolution{4};
+    static constexpr double kOrthonormalTolerance{1e-6};
+};
+
+template <>
+struct ScalarTraits<float> {
+    static constexpr int kResolution{4};
+    static constexpr float kOrthonormalTolerance{1e-3f};
+};
+
+// a * b + c. Built with EKUMEN_MATH_FMA (CMake option CPPCOURSE_FMA) this is a fused
+// multiply-add with a single rounding, otherwise a multiply followed by an add.
+constexpr double MultiplyAdd(const double a, const double b, const double c) {
+#ifdef EKUMEN_MATH_FMA
+    return __builtin_fma(a, b, c);
+#else
+    return a * b + c;
+#endif
+}
+
+constexpr float MultiplyAdd(const float a, const float b, const float c) {
+#ifdef EKUMEN_MATH_FMA
+    return __builtin_fmaf(a, b, c);
+#else
+    return a * b + c;
+#endif
+}
+
+// a * b - c * d. With FMA the rounding error of c * d is recovered exactly and added back
+// (Kahan's algorithm), which keeps the result within 1.5 ulp even when the products cancel.
+template <class T>
+constexpr T DifferenceOfProducts(const T a, const T b, const T c, const T d) {
+#ifdef EKUMEN_MATH_FMA
+    const T cd = c * d;
+    const T error = MultiplyAdd(-c, d, cd);
+    return MultiplyAdd(a, b, -cd) + error;
+#else
+    return a * b - c * d;
+#endif
+}
+
+// Elements are kept in an array rather than named members, so an index maps straight to an
+// address and operator[] needs no branches.
+template <class T>
 struct Elements {
-    Elements() : x_(0), y_(0), z_(0) {};
-    Elements(const double &x, const double &y, const double &z) : x_(x), y_(y), z_(z) {}; 
-    double x_,y_,z_;
+    constexpr Elements() : values_{0, 0, 0} {};
+    constexpr Elements(const T &x, const T &y, const T &z) : values_{x, y, z} {};
+    T values_[3];
 };
 
-class Vector3 {
+template <class T>
+class Vector3T {
     public:
-        Vector3() : v_(new Elements{}) {};
-        Vector3(const double &x, const double &y, const double &z) : v_(new Elements{x, y, z}) {};
-        explicit Vector3(std::initializer_list<double> elements);
-        ~Vector3() {
-            // deallocate
-            delete v_;  
-        };
-
-        // copy constructor
-        Vector3(const Vector3& other) : v_(new Elements{*(other.v_)}) {};
-
-        // move constructor
-        Vector3(Vector3&& other) {
-            v_ = other.v_;
-            other.v_ = nullptr;
-        }
+        using Scalar = T;
+
+        constexpr Vector3T() : v_{} {};
+        constexpr Vector3T(const T &x, const T &y, const T &z) : v_{x, y, z} {};
+        explicit constexpr Vector3T(std::initializer_list<T> elements);
+        // Explicit conversion from another scalar precision.
+        template <class U>
+        explicit constexpr Vector3T(const Vector3T<U>& other)
+            : v_{static_cast<T>(other.x()), static_cast<T>(other.y()), static_cast<T>(other.z())} {};
+
+        // Elements are stored inline, so copies and moves are plain memberwise copies
+        // and the type stays trivially copyable.
+        Vector3T(const Vector3T<T>& other) = default;
+        Vector3T(Vector3T<T>&& other) = default;
+        ~Vector3T() = default;
 
         // Getter for elements of the vector.
-        const double& x() const { return v_->x_; };
-        const double& y() const { return v_->y_; };
-        const double& z() const { return v_->z_; };
+        constexpr const T& x() const { return v_.values_[0]; };
+        constexpr const T& y() const { return v_.values_[1]; };
+        constexpr const T& z() const { return v_.values_[2]; };
 
         // Setter for elements of the vector.
-        double& x() { return v_->x_; };
-        double& y() { return v_->y_; };
-        double& z() { return v_->z_; };
+        constexpr T& x() { return v_.values_[0]; };
+        constexpr T& y() { return v_.values_[1]; };
+        constexpr T& z() { return v_.values_[2]; };
 
         // Operators overloading.
-        Vector3 operator+(const Vector3& vector) const;
-        Vector3 operator-(const Vector3& vector) const;
-        Vector3 operator*(const double& value) const;
-        Vector3 operator*(const Vector3& vector) const;
-        Vector3 operator/(const double& value) const;
-        Vector3 operator/(const Vector3& vector) const;
-        Vector3& operator+=(const Vector3& vector);
-        Vector3& operator-=(const Vector3& vector);
-        Vector3& operator*=(const double& value);
-        Vector3& operator*=(const Vector3& vector);
-        Vector3& operator/=(const double& vector);
-        Vector3& operator/=(const Vector3& vector);
-        const double& operator[](const int &index) const;
-        double& operator[](const int &index);
-        bool operator==(const std::initializer_list<double>& rhs) const;
-        bool operator==(const Vector3& a) const;
-        bool operator!=(const std::initializer_list<double>& rhs) const;
-        bool operator!=(const Vector3& a) const;
-        Vector3& operator=(const Vector3& other);
-        Vector3& operator=(Vector3&& other);
-        double dot(const Vector3& vector) const;
-        double norm() const;
-        Vector3 cross(const Vector3& vector) const;
+        constexpr Vector3T<T> operator+(const Vector3T<T>& vector) const;
+        constexpr Vector3T<T> operator-(const Vector3T<T>& vector) const;
+        constexpr Vector3T<T> operator*(const T& value) const;
+        constexpr Vector3T<T> operator*(const Vector3T<T>& vector) const;
+        constexpr Vector3T<T> operator/(const T& value) const;
+        constexpr Vector3T<T> operator/(const Vector3T<T>& vector) const;
+        constexpr Vector3T<T>& operator+=(const Vector3T<T>& vector);
+        constexpr Vector3T<T>& operator-=(const Vector3T<T>& vector);
+        constexpr Vector3T<T>& operator*=(const T& value);
+        constexpr Vector3T<T>& operator*=(const Vector3T<T>& vector);
+        constexpr Vector3T<T>& operator/=(const T& vector);
+        constexpr Vector3T<T>& operator/=(const Vector3T<T>& vector);
+        // Indices outside [0, 2] throw std::out_of_range in checked builds and are undefined
+        // otherwise, see CPPCOURSE_CHECKED_ACCESS in CMakeLists.txt.
+        constexpr const T& operator[](const int &index) const;
+        constexpr T& operator[](const int &index);
+        bool operator==(const std::initializer_list<T>& rhs) const;
+        bool operator==(const Vector3T<T>& a) const;
+        bool operator!=(const std::initializer_list<T>& rhs) const;
+        bool operator!=(const Vector3T<T>& a) const;
+        Vector3T<T>& operator=(const Vector3T<T>& other) = default;
+        Vector3T<T>& operator=(Vector3T<T>&& other) = default;
+        constexpr T dot(const Vector3T<T>& vector) const;
+        T norm() const;
+        constexpr Vector3T<T> cross(const Vector3T<T>& vector) const;
 
         // Class constants
-        static const Vector3 kUnitX;
-        static const Vector3 kUnitY;
-        static const Vector3 kUnitZ;
-        static const Vector3 kZero;
+        static const Vector3T<T> kUnitX;
+        static const Vector3T<T> kUnitY;
+        static const Vector3T<T> kUnitZ;
+        static const Vector3T<T> kZero;
 
     private:
-        Elements *v_;
+        Elements<T> v_;
 };
 
-inline Vector3 operator*(const double scalar, const Vector3& vector) {
-    Vector3 result(vector.x() * scalar, vector.y() * scalar, (vector.z() * scalar));
+// Arithmetic is defined inline so that chained expressions such as r * p + t compile
+// down to a single pass over the components, with no intermediate objects left behind.
+// Compound assignments update the elements in place. Everything but norm() is constexpr,
+// so fixed frames can be computed at compile time. Supported scalar types are float and
+// double, see the aliases below each class.
+template <class T>
+constexpr Vector3T<T>::Vector3T(std::initializer_list<T> elements) : v_{} {
+    if (elements.size() != 3) {
+        throw std::range_error("Elements out of range, Vector3 only have three elements");
+    }
+    auto it = elements.begin();
+    x() = *it++;
+    y() = *it++;
+    z() = *it++;
+}
+
+template <class T>
+constexpr Vector3T<T> Vector3T<T>::operator+(const Vector3T<T>& vector) const {
+    return Vector3T<T>(x() + vector.x(), y() + vector.y(), z() + vector.z());
+}
+
+template <class T>
+constexpr Vector3T<T> Vector3T<T>::operator-(const Vector3T<T>& vector) const {
+    return Vector3T<T>(x() - vector.x(), y() - vector.y(), z() - vector.z());
+}
+
+template <class T>
+constexpr Vector3T<T> Vector3T<T>::operator*(const T& value) const {
+    return Vector3T<T>(x() * value, y() * value, z() * value);
+}
+
+template <class T>
+constexpr Vector3T<T> Vector3T<T>::operator*(const Vector3T<T>& vector) const {
+    return Vector3T<T>(x() * vector.x(), y() * vector.y(), z() * vector.z());
+}
+
+template <class T>
+constexpr Vector3T<T> Vector3T<T>::operator/(const T& value) const {
+    return Vector3T<T>(x() / value, y() / value, z() / value);
+}
+
+template <class T>
+constexpr Vector3T<T> Vector3T<T>::operator/(const Vector3T<T>& vector) const {
+    return Vector3T<T>(x() / vector.x(), y() / vector.y(), z() / vector.z());
+}
+
+template <class T>
+constexpr Vector3T<T>& Vector3T<T>::operator+=(const Vector3T<T>& vector) {
+    x() += vector.x();
+    y() += vector.y();
+    z() += vector.z();
+    return *this;
+}
+
+template <class T>
+constexpr Vector3T<T>& Vector3T<T>::operator-=(const Vector3T<T>& vector) {
+    x() -= vector.x();
+    y() -= vector.y();
+    z() -= vector.z();
+    return *this;
+}
+
+template <class T>
+constexpr Vector3T<T>& Vector3T<T>::operator*=(const T& value) {
+    x() *= value;
+    y() *= value;
+    z() *= value;
+    return *this;
+}
+
+template <class T>
+constexpr Vector3T<T>& Vector3T<T>::operator*=(const Vector3T<T>& vector) {
+    x() *= vector.x();
+    y() *= vector.y();
+    z() *= vector.z();
+    return *this;
+}
+
+template <class T>
+constexpr Vector3T<T>& Vector3T<T>::operator/=(const Vector3T<T>& vector) {
+    x() /= vector.x();
+    y() /= vector.y();
+    z() /= vector.z();
+    return *this;
+}
+
+template <class T>
+constexpr Vector3T<T>& Vector3T<T>::operator/=(const T& value) {
+    x() /= value;
+    y() /= value;
+    z() /= value;
+    return *this;
+}
+
+template <class T>
+constexpr const T& Vector3T<T>::operator[](const int &index) const {
+#ifdef EKUMEN_MATH_CHECKED_ACCESS
+    if (index < 0 || index > 2) {
+        throw std::out_of_range("index out of range, Vector3 only have three elements");
+    }
+#endif
+    return v_.values_[index];
+}
+
+template <class T>
+constexpr T& Vector3T<T>::operator[](const int &index) {
+#ifdef EKUMEN_MATH_CHECKED_ACCESS
+    if (index < 0 || index > 2) {
+        throw std::out_of_range("index out of range, Vector3 only have three elements");
+    }
+#endif
+    return v_.values_[index];
+}
+
+template <class T>
+inline T Vector3T<T>::norm() const {
+    return std::sqrt(dot(*this));
+}
+
+template <class T>
+constexpr T Vector3T<T>::dot(const Vector3T<T>& vector) const {
+    return MultiplyAdd(z(), vector.z(), MultiplyAdd(y(), vector.y(), x() * vector.x()));
+}
+
+template <class T>
+constexpr Vector3T<T> Vector3T<T>::cross(const Vector3T<T>& vector) const {
+    auto i = DifferenceOfProducts(y(), vector.z(), vector.y(), z());
+    auto j = DifferenceOfProducts(z(), vector.x(), vector.z(), x());
+    auto k = DifferenceOfProducts(x(), vector.y(), vector.x(), y());
+
+    return Vector3T<T>(i, j, k);
+}
+
+// |scalar| is not deduced, so 2 * vector works for any scalar type.
+template <class T>
+constexpr Vector3T<T> operator*(const typename Vector3T<T>::Scalar scalar, const Vector3T<T>& vector) {
+    Vector3T<T> result(vector.x() * scalar, vector.y() * scalar, (vector.z() * scalar));
     return result;
 }
 
-inline std::ostream& operator<<(std::ostream& os, const Vector3& vector) {
-    return os << "(x: " << std::to_string(static_cast<int>(vector.x()))
-              << ", y: " << std::to_string(static_cast<int>(vector.y()))
-              << ", z: " << std::to_string(static_cast<int>(vector.z())) << ")";
+// Prints the shortest text that parses back to the same values, see text_format.h.
+template <class T>
+inline std::ostream& operator<<(std::ostream& os, const Vector3T<T>& vector) {
+    char buffer[kMaxVector3Chars];
+    return os.write(buffer, Format(vector, buffer) - buffer);
 }
 
+template <class T>
+constexpr Vector3T<T> Vector3T<T>::kUnitX = Vector3T<T>(1., 0., 0.);
+template <class T>
+constexpr Vector3T<T> Vector3T<T>::kUnitY = Vector3T<T>(0., 1., 0.);
+template <class T>
+constexpr Vector3T<T> Vector3T<T>::kUnitZ = Vector3T<T>(0., 0., 1.);
+template <class T>
+constexpr Vector3T<T> Vector3T<T>::kZero = Vector3T<T>(0., 0., 0.);
+
+using Vector3 = Vector3T<double>;
+using Vector3f = Vector3T<float>;
+
+template <class T>
 struct Rows {
-    Rows() : r1_(), r2_(), r3_() {};
-    Rows(const Vector3 &r1, const Vector3 &r2, const Vector3 &r3) : r1_(r1), r2_(r2), r3_(r3) {}; 
-    Vector3 r1_,r2_,r3_;
+    constexpr Rows() : rows_{} {};
+    constexpr Rows(const Vector3T<T> &r1, const Vector3T<T> &r2, const Vector3T<T> &r3) : rows_{r1, r2, r3} {};
+    Vector3T<T> rows_[3];
 };
 
+template <class T>
+struct InverseResultT;
 
-class Matrix3 {
+template <class T>
+class Matrix3T {
 
     public:
-        Matrix3() : m_(new Rows{}) {};
+        using Scalar = T;
 
-        Matrix3(const Vector3 &r1, const Vector3 &r2, const Vector3 &r3) : m_(new Rows{r1, r2, r3}) {};
-        Matrix3(const std::initializer_list<double>& values);
-        ~Matrix3() {
-            // deallocate
-            delete m_;  
-        };
+        constexpr Matrix3T() : m_{} {};
 
-        // copy constructor
-        Matrix3(const Matrix3& other) : m_(new Rows{*(other.m_)}) {};
+        constexpr Matrix3T(const Vector3T<T> &r1, const Vector3T<T> &r2, const Vector3T<T> &r3) : m_{r1, r2, r3} {};
+        constexpr Matrix3T(const std::initializer_list<T>& values);
+        // Explicit conversion from another scalar precision.
+        template <class U>
+        explicit constexpr Matrix3T(const Matrix3T<U>& other)
+            : m_{Vector3T<T>(other.r1()), Vector3T<T>(other.r2()), Vector3T<T>(other.r3())} {};
 
-        // move constructor
-        Matrix3(Matrix3&& other) {
-            m_ = other.m_;
-            other.m_ = nullptr;
-        };
+        // Rows are stored inline as nine contiguous row-major scalars, so copies and
+        // moves never allocate.
+        Matrix3T(const Matrix3T<T>& other) = default;
+        Matrix3T(Matrix3T<T>&& other) = default;
+        ~Matrix3T() = default;
 
         // Getter
-        const Vector3& row(uint32_t index) const;
-        const Vector3 col(uint32_t index) const;
+        constexpr const Vector3T<T>& row(uint32_t index) const;
+        constexpr const Vector3T<T> col(uint32_t index) const;
 
         // Getter for elements of the vector.
-        const Vector3& r1() const { return m_->r1_; };
-        const Vector3& r2() const { return m_->r2_; };
-        const Vector3& r3() const { return m_->r3_; };
+        constexpr const Vector3T<T>& r1() const { return m_.rows_[0]; };
+        constexpr const Vector3T<T>& r2() const { return m_.rows_[1]; };
+        constexpr const Vector3T<T>& r3() const { return m_.rows_[2]; };
 
         // Setter for elements of the vector.
-        Vector3& r1() { return m_->r1_; };
-        Vector3& r2() { return m_->r2_; };
-        Vector3& r3() { return m_->r3_; };
+        constexpr Vector3T<T>& r1() { return m_.rows_[0]; };
+        constexpr Vector3T<T>& r2() { return m_.rows_[1]; };
+        constexpr Vector3T<T>& r3() { return m_.rows_[2]; };
 
         // Operators overloading.
-        Vector3& operator[](const uint32_t index);
-        const Vector3& operator[](const uint32_t index) const;
-        Matrix3 operator+(const Matrix3& matrix) const;
-        Matrix3 operator-(const Matrix3& matrix) const;
-        Matrix3 operator*(const double& value) const;
-        Matrix3 operator*(const Matrix3& matrix) const;
-        Vector3 operator*(const Vector3& vector) const;
-        Matrix3 operator/(const Matrix3& matrix) const;
-        Matrix3 operator/(const double& value) const;
-        Matrix3& operator+=(const Matrix3& matrix);
-        Matrix3& operator-=(const Matrix3& matrix);
-        Matrix3& operator*=(const double& value);
-        Matrix3& operator*=(const Matrix3& matrix);
-        Matrix3& operator/=(const Matrix3& matrix);
-        bool operator==(const Matrix3& matrix) const;
-        bool operator!=(const Matrix3& matrix) const;
-        Matrix3& operator=(const Matrix3& matrix);
-        Matrix3& operator=(Matrix3&& matrix);
-        double det() const;
-        Matrix3 inverse() const; 
+        // Row access, checked like Vector3T::operator[].
+        constexpr Vector3T<T>& operator[](const uint32_t index);
+        constexpr const Vector3T<T>& operator[](const uint32_t index) const;
+        constexpr Matrix3T<T> operator+(const Matrix3T<T>& matrix) const;
+        constexpr Matrix3T<T> operator-(const Matrix3T<T>& matrix) const;
+        constexpr Matrix3T<T> operator*(const T& value) const;
+        constexpr Matrix3T<T> operator*(const Matrix3T<T>& matrix) const;
+        constexpr Vector3T<T> operator*(const Vector3T<T>& vector) const;
+        constexpr Matrix3T<T> operator/(const Matrix3T<T>& matrix) const;
+        constexpr Matrix3T<T> operator/(const T& value) const;
+        constexpr Matrix3T<T>& operator+=(const Matrix3T<T>& matrix);
+        constexpr Matrix3T<T>& operator-=(const Matrix3T<T>& matrix);
+        constexpr Matrix3T<T>& operator*=(const T& value);
+        constexpr Matrix3T<T>& operator*=(const Matrix3T<T>& matrix);
+        constexpr Matrix3T<T>& operator/=(const Matrix3T<T>& matrix);
+        bool operator==(const Matrix3T<T>& matrix) const;
+        bool operator!=(const Matrix3T<T>& matrix) const;
+        Matrix3T<T>& operator=(const Matrix3T<T>& matrix) = default;
+        Matrix3T<T>& operator=(Matrix3T<T>&& matrix) = default;
+        constexpr T det() const;
+        // Throws std::domain_error if the matrix is singular.
+        Matrix3T<T> inverse() const;
+        // Same inverse as inverse(), but reports a singular matrix through the status instead of
+        // throwing, together with the condition number.
+        InverseResultT<T> tryInverse() const noexcept;
+        // Matrix product. Note that operator* multiplies element by element.
+        constexpr Matrix3T<T> product(const Matrix3T<T>& matrix) const;
+        constexpr Matrix3T<T> transpose() const;
+        // True when every row has unit norm and rows are mutually orthogonal, within |tolerance|.
+        // False if any element is NaN or infinite.
+        constexpr bool isOrthonormal(const T tolerance) const;
 
         // Constants
-        static const Matrix3 kIdentity;
-        static const Matrix3 kZero;
-        static const Matrix3 kOnes;
+        static const Matrix3T<T> kIdentity;
+        static const Matrix3T<T> kZero;
+        static const Matrix3T<T> kOnes;
     private:
-        Rows *m_;
-    
+        static_assert(sizeof(Rows<T>) == 9 * sizeof(T), "Matrix3 rows must be contiguous");
+        // Transposed matrix of cofactors, the inverse times det().
+        Matrix3T<T> adjugate() const;
+        Rows<T> m_;
 };
 
-inline Matrix3 operator*(const double scalar, const Matrix3& vector) {
-    Matrix3 result(vector.r1() * scalar, vector.r2() * scalar, (vector.r3() * scalar));
+template <class T>
+constexpr Matrix3T<T>::Matrix3T(const std::initializer_list<T>& values) : m_{} {
+    if(values.size() != 9) {
+        throw "Invalid initializer list size";
+    }
+    auto it = values.begin();
+    for (uint32_t i = 0; i < 3; ++i) {
+        for (int j = 0; j < 3; ++j) {
+            (*this)[i][j] = *it++;
+        }
+    }
+}
+
+template <class T>
+constexpr const Vector3T<T>& Matrix3T<T>::row(uint32_t index) const {
+    if(index > 2) {
+        throw std::out_of_range("index out of range, Matrix3 only have three rows");
+    }
+    return (*this)[index];
+}
+
+template <class T>
+constexpr const Vector3T<T> Matrix3T<T>::col(uint32_t index) const {
+    if(index > 2) {
+        throw std::out_of_range("index out of range, Matrix3 only have three rows");
+    }
+    return Vector3T<T>(r1()[index], r2()[index], r3()[index]);
+}
+
+template <class T>
+constexpr Vector3T<T>& Matrix3T<T>::operator[](const uint32_t index) {
+#ifdef EKUMEN_MATH_CHECKED_ACCESS
+    if (index > 2) {
+        throw std::out_of_range("Error. Invalid row index for Matrix3");
+    }
+#endif
+    return m_.rows_[index];
+}
+
+template <class T>
+constexpr const Vector3T<T>& Matrix3T<T>::operator[](const uint32_t index) const {
+#ifdef EKUMEN_MATH_CHECKED_ACCESS
+    if (index > 2) {
+        throw std::out_of_range("Error. Invalid row index for Matrix3");
+    }
+#endif
+    return m_.rows_[index];
+}
+
+template <class T>
+constexpr Matrix3T<T> Matrix3T<T>::operator+(const Matrix3T<T>& matrix) const {
+    return Matrix3T<T>(r1() + matrix.r1(), r2() + matrix.r2(), r3() + matrix.r3());
+}
+
+template <class T>
+constexpr Matrix3T<T> Matrix3T<T>::operator-(const Matrix3T<T>& matrix) const {
+    return Matrix3T<T>(r1() - matrix.r1(), r2() - matrix.r2(), r3() - matrix.r3());
+}
+
+template <class T>
+constexpr Matrix3T<T> Matrix3T<T>::operator*(const T& value) const {
+    return Matrix3T<T>(r1() * value, r2() * value, r3() * value);
+}
+
+template <class T>
+constexpr Matrix3T<T> Matrix3T<T>::operator*(const Matrix3T<T>& matrix) const {
+    return Matrix3T<T>(r1() * matrix.r1(), r2() * matrix.r2(), r3() * matrix.r3());
+}
+
+template <class T>
+constexpr Vector3T<T> Matrix3T<T>::operator*(const Vector3T<T>& vector) const {
+    return Vector3T<T>(r1().dot(vector), r2().dot(vector), r3().dot(vector));
+}
+
+template <class T>
+constexpr Matrix3T<T> Matrix3T<T>::operator/(const Matrix3T<T>& matrix) const {
+    return Matrix3T<T>(r1() / matrix.r1(), r2() / matrix.r2(), r3() / matrix.r3());
+}
+
+template <class T>
+constexpr Matrix3T<T> Matrix3T<T>::operator/(const T& value) const {
+    return Matrix3T<T>(r1() / value, r2() / value, r3() / value);
+}
+
+template <class T>
+constexpr Matrix3T<T>& Matrix3T<T>::operator+=(const Matrix3T<T>& matrix) {
+    r1() += matrix.r1();
+    r2() += matrix.r2();
+    r3() += matrix.r3();
+    return *this;
+}
+
+template <class T>
+constexpr Matrix3T<T>& Matrix3T<T>::operator-=(const Matrix3T<T>& matrix) {
+    r1() -= matrix.r1();
+    r2() -= matrix.r2();
+    r3() -= matrix.r3();
+    return *this;
+}
+
+template <class T>
+constexpr Matrix3T<T>& Matrix3T<T>::operator*=(const T& value) {
+    r1() *= value;
+    r2() *= value;
+    r3() *= value;
+    return *this;
+}
+
+template <class T>
+constexpr Matrix3T<T>& Matrix3T<T>::operator*=(const Matrix3T<T>& matrix) {
+    r1() *= matrix.r1();
+    r2() *= matrix.r2();
+    r3() *= matrix.r3();
+    return *this;
+}
+
+template <class T>
+constexpr Matrix3T<T>& Matrix3T<T>::operator/=(const Matrix3T<T>& matrix) {
+    r1() /= matrix.r1();
+    r2() /= matrix.r2();
+    r3() /= matrix.r3();
+    return *this;
+}
+
+template <class T>
+constexpr Matrix3T<T> Matrix3T<T>::product(const Matrix3T<T>& matrix) const {
+    const Vector3T<T>& a1 = r1();
+    const Vector3T<T>& a2 = r2();
+    const Vector3T<T>& a3 = r3();
+    const Vector3T<T>& b1 = matrix.r1();
+    const Vector3T<T>& b2 = matrix.r2();
+    const Vector3T<T>& b3 = matrix.r3();
+    // Row i of the product is a_i.x * b1 + a_i.y * b2 + a_i.z * b3.
+    return Matrix3T<T>(b1 * a1.x() + b2 * a1.y() + b3 * a1.z(),
+                       b1 * a2.x() + b2 * a2.y() + b3 * a2.z(),
+                       b1 * a3.x() + b2 * a3.y() + b3 * a3.z());
+}
+
+template <class T>
+constexpr Matrix3T<T> Matrix3T<T>::transpose() const {
+    return Matrix3T<T>(Vector3T<T>(r1().x(), r2().x(), r3().x()),
+                       Vector3T<T>(r1().y(), r2().y(), r3().y()),
+                       Vector3T<T>(r1().z(), r2().z(), r3().z()));
+}
+
+template <class T>
+constexpr bool Matrix3T<T>::isOrthonormal(const T tolerance) const {
+    // std::abs is not constexpr.
+    const T errors[]{r1().dot(r1()) - T(1), r2().dot(r2()) - T(1), r3().dot(r3()) - T(1),
+                     r1().dot(r2()), r1().dot(r3()), r2().dot(r3())};
+    for (const T error : errors) {
+        // Written so that NaN fails the test.
+        if (!(error <= tolerance && -error <= tolerance)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <class T>
+constexpr T Matrix3T<T>::det() const {
+    T subdet1 = DifferenceOfProducts(r2()[1], r3()[2], r2()[2], r3()[1]);
+    T subdet2 = DifferenceOfProducts(r2()[0], r3()[2], r2()[2], r3()[0]);
+    T subdet3 = DifferenceOfProducts(r2()[0], r3()[1], r2()[1], r3()[0]);
+    // Same order of operations as r1[0] * subdet1 - r1[1] * subdet2 + r1[2] * subdet3.
+    return MultiplyAdd(r1()[2], subdet3, MultiplyAdd(-r1()[1], subdet2, r1()[0] * subdet1));
+}
+
+template <class T>
+constexpr Matrix3T<T> operator*(const typename Matrix3T<T>::Scalar scalar, const Matrix3T<T>& vector) {
+    Matrix3T<T> result(vector.r1() * scalar, vector.r2() * scalar, (vector.r3() * scalar));
     return result;
 }
 
-// Warning: it convert float values in int, we used this way to pas the test, for other use take out " static_cast<int>" 
-inline std::ostream& operator<<(std::ostream& os, const Matrix3& matrix) {
-    return os << "[[" << std::to_string(static_cast<int>(matrix[0][0])) << ", "
-              << std::to_string(static_cast<int>(matrix[0][1])) << ", " << std::to_string(static_cast<int>(matrix[0][2]))
-              << "], "
-              << "[" << std::to_string(static_cast<int>(matrix[1][0])) << ", "
-              << std::to_string(static_cast<int>(matrix[1][1])) << ", " << std::to_string(static_cast<int>(matrix[1][2]))
-              << "], "
-              << "[" << std::to_string(static_cast<int>(matrix[2][0])) << ", "
-              << std::to_string(static_cast<int>(matrix[2][1])) << ", " << std::to_string(static_cast<int>(matrix[2][2]))
-              << "]]";
+template <class T>
+inline std::ostream& operator<<(std::ostream& os, const Matrix3T<T>& matrix) {
+    char buffer[kMaxMatrix3Chars];
+    return os.write(buffer, Format(matrix, buffer) - buffer);
 }
 
-class Isometry {
+template <class T>
+constexpr Matrix3T<T> Matrix3T<T>::kIdentity =
+    Matrix3T<T>(Vector3T<T>(1., 0., 0.), Vector3T<T>(0., 1., 0.), Vector3T<T>(0., 0., 1.));
+template <class T>
+constexpr Matrix3T<T> Matrix3T<T>::kZero =
+    Matrix3T<T>(Vector3T<T>(0., 0., 0.), Vector3T<T>(0., 0., 0.), Vector3T<T>(0., 0., 0.));
+template <class T>
+constexpr Matrix3T<T> Matrix3T<T>::kOnes =
+    Matrix3T<T>(Vector3T<T>(1., 1., 1.), Vector3T<T>(1., 1., 1.), Vector3T<T>(1., 1., 1.));
+
+using Matrix3 = Matrix3T<double>;
+using Matrix3f = Matrix3T<float>;
+
+enum class InverseStatus {
+    kOk,
+    // det() is zero as far as inverse() can tell, which would throw.
+    kSingular,
+};
+
+// Result of Matrix3T::tryInverse().
+template <class T>
+struct InverseResultT {
+    InverseStatus status;
+    // The inverse, or kZero when singular.
+    Matrix3T<T> inverse;
+    // 1-norm condition number, ||A||_1 * ||A^-1||_1: 1 for rotations, growing as the matrix nears
+    // singularity, infinite when singular. Roughly, log10 of it is the number of decimal digits
+    // the inverse loses, so callers can reject or fall back, e.g. to a pseudo-inverse, well
+    // before the status turns kSingular.
+    T condition;
+
+    bool ok() const { return status == InverseStatus::kOk; }
+};
+
+using InverseResult = InverseResultT<double>;
+using InverseResultf = InverseResultT<float>;
+
+// Rigid transform: a rotation followed by a translation. The rotation must be orthonormal,
+// which lets inverse() transpose it instead of running a general matrix inverse. Debug
+// builds check this on construction.
+template <class T>
+class IsometryT {
    public:
-    explicit Isometry(const Matrix3& rotation);
-    Isometry(const Vector3& translation, const Matrix3& rotation);
-
-    Isometry compose(const Isometry& isometry) const;
-    Isometry inverse() const;
-    const Matrix3& rotation() const { return rotation_; };
-    Vector3 transform(const Vector3& translation) const { return (rotation_ * translation + translation_); };
-    const Vector3& translation() const { return translation_; };
-    static Isometry FromTranslation(const Vector3& values);
-    static Isometry FromEulerAngles(const double yaw, const double pitch, const double roll);
-    static Isometry RotateAround(const Vector3& axis, const double angle);
+    using Scalar = T;
+
+    // Tolerance used by the debug orthonormality check.
+    static constexpr T kOrthonormalTolerance{ScalarTraits<T>::kOrthonormalTolerance};
+
+    explicit constexpr IsometryT(const Matrix3T<T>& rotation);
+    constexpr IsometryT(const Vector3T<T>& translation, const Matrix3T<T>& rotation);
+    // Explicit conversion from another scalar precision.
+    template <class U>
+    explicit constexpr IsometryT(const IsometryT<U>& other)
+        : IsometryT(Vector3T<T>(other.translation()), Matrix3T<T>(other.rotation())) {};
+
+    constexpr IsometryT<T> compose(const IsometryT<T>& isometry) const;
+    constexpr IsometryT<T> inverse() const;
+    constexpr const Matrix3T<T>& rotation() const { return rotation_; };
+    constexpr Vector3T<T> transform(const Vector3T<T>& translation) const { return *this * translation; };
+    // Transforms |count| points stored as an array of vectors into |out|. |out| may alias |points|
+    // to transform in place.
+    void transform(const Vector3T<T>* points, Vector3T<T>* out, size_t count) const;
+    // Transforms |count| points stored as separate x, y and z arrays into the |out_*| arrays.
+    // Output arrays may alias the input arrays to transform in place. Runs the widest SIMD
+    // kernel available on the running CPU, see transform_kernels.h.
+    void transform(const T* x, const T* y, const T* z, T* out_x, T* out_y, T* out_z,
+                   size_t count) const;
+    constexpr const Vector3T<T>& translation() const { return translation_; };
+    // Replaces the rotation with the nearest proper rotation, see NearestRotation() in svd.h.
+    // Long chains of products accumulate rounding that drifts the rotation off SO(3); calling
+    // this now and then on long-lived poses keeps it orthonormal. It costs a full SVD, about
+    // as much as a dozen products, so renormalize every so many steps rather than after each.
+    void normalize();
+    constexpr static IsometryT<T> FromTranslation(const Vector3T<T>& values);
+    static IsometryT<T> FromEulerAngles(const T yaw, const T pitch, const T roll);
+    static IsometryT<T> RotateAround(const Vector3T<T>& axis, const T angle);
 
     // // Operators
-    bool operator==(const Isometry& isometry) const;
-    Vector3 operator*(const Vector3& vector) const;
-    Isometry operator*(const Isometry& isometry) const;
+    bool operator==(const IsometryT<T>& isometry) const;
+    constexpr Vector3T<T> operator*(const Vector3T<T>& vector) const;
+    constexpr IsometryT<T> operator*(const IsometryT<T>& isometry) const;
 
    private:
-    Matrix3 rotation_;
-    Vector3 translation_;
+    Matrix3T<T> rotation_;
+    Vector3T<T> translation_;
 };
 
-inline std::ostream& operator<<(std::ostream& os, const Isometry& isometri) {
-    auto rotation = isometri.rotation();
-    return os << "[T: (x: 0, y: 0, z: 0" << "), R:[[" 
-              << std::setprecision(9) << rotation[0][0] << ", " << rotation[0][1] << ", " << rotation[0][2] << "], "
-              << "[" << rotation[1][0] << ", " << rotation[1][1] << ", " << rotation[1][2] << "], "
-              << "[" << rotation[2][0] << ", " << rotation[2][1] << ", " << rotation[2][2] << "]]]";
+template <class T>
+constexpr T IsometryT<T>::kOrthonormalTolerance;
+
+template <class T>
+constexpr IsometryT<T>::IsometryT(const Matrix3T<T>& rotation) : rotation_(rotation), translation_() {
+    assert(rotation.isOrthonormal(kOrthonormalTolerance) && "Isometry rotation must be orthonormal");
 }
+
+template <class T>
+constexpr IsometryT<T>::IsometryT(const Vector3T<T>& translation, const Matrix3T<T>& rotation)
+    : rotation_(rotation), translation_(translation) {
+    assert(rotation.isOrthonormal(kOrthonormalTolerance) && "Isometry rotation must be orthonormal");
+}
+
+template <class T>
+constexpr IsometryT<T> IsometryT<T>::FromTranslation(const Vector3T<T>& vector) {
+    return IsometryT<T>(vector, Matrix3T<T>(Vector3T<T>(1., 0., 0.), Vector3T<T>(0., 1., 0.), Vector3T<T>(0., 0., 1.)));
+}
+
+template <class T>
+constexpr IsometryT<T> IsometryT<T>::compose(const IsometryT<T>& isometry) const {
+    return *this * isometry;
+}
+
+template <class T>
+constexpr IsometryT<T> IsometryT<T>::inverse() const {
+    // The inverse of an orthonormal rotation is its transpose.
+    const Matrix3T<T> rotation = rotation_.transpose();
+    return IsometryT<T>{(rotation * translation_) * -1, rotation};
+}
+
+template <class T>
+constexpr Vector3T<T> IsometryT<T>::operator*(const Vector3T<T>& vector) const {
+    return (rotation_ * vector + translation_);
+}
+
+template <class T>
+constexpr IsometryT<T> IsometryT<T>::operator*(const IsometryT<T>& isometry) const {
+    return IsometryT<T>((rotation_ * isometry.translation()) + translation_, rotation_.product(isometry.rotation()));
+}
+
+template <class T>
+inline std::ostream& operator<<(std::ostream& os, const IsometryT<T>& isometry) {
+    char buffer[kMaxIsometryChars];
+    return os.write(buffer, Format(isometry, buffer) - buffer);
+}
+
+using Isometry = IsometryT<double>;
+using Isometryf = IsometryT<float>;
+
 }
 }
@@ -0,0 +1,58 @@
+#pragma once
+
+// Standard libraries
+#include <cstddef>
+
+#include "isometry.h"
+
+namespace ekumen {
+namespace math {
+
+// Tangent vector of a rigid transform: |angular| is a rotation vector, axis times angle in
+// radians, and |linear| the translational velocity in the rotating frame. Exp() of a twist
+// moves along the screw motion it describes for unit time.
+template <class T>
+struct TwistT {
+    Vector3T<T> linear;
+    Vector3T<T> angular;
+};
+
+using Twist = TwistT<double>;
+using Twistf = TwistT<float>;
+
+// Exponential and logarithm maps of SO(3) and SE(3).
+//
+// Exp is stable at every angle. Log returns a rotation vector of norm in [0, pi]; near pi it
+// recovers the axis from the symmetric part of the rotation, where the skew-symmetric part
+// vanishes. Below an angle of about 1e-2 (double) or 0.2 (float) both maps switch to Taylor
+// expansions of their coefficients, which are exact to machine precision there, handle the
+// zero angle and skip the trigonometric calls.
+
+// Rotation of |rotation_vector|.norm() radians around its direction.
+template <class T>
+Matrix3T<T> ExpSO3(const Vector3T<T>& rotation_vector);
+
+// Inverse of ExpSO3(). |rotation| must be orthonormal.
+template <class T>
+Vector3T<T> LogSO3(const Matrix3T<T>& rotation);
+
+template <class T>
+IsometryT<T> ExpSE3(const TwistT<T>& twist);
+
+// Inverse of ExpSE3().
+template <class T>
+TwistT<T> LogSE3(const IsometryT<T>& isometry);
+
+// Element-wise ExpSE3() and LogSE3() over arrays, without per-call overhead.
+template <class T>
+void ExpSE3Batch(const TwistT<T>* twists, IsometryT<T>* out, size_t count);
+template <class T>
+void LogSE3Batch(const IsometryT<T>* isometries, TwistT<T>* out, size_t count);
+
+// Moves from |from| towards |to| along the screw motion joining them, |t| in [0, 1]:
+// from * ExpSE3(t * LogSE3(from^-1 * to)).
+template <class T>
+IsometryT<T> Interpolate(const IsometryT<T>& from, const IsometryT<T>& to, const T t);
+
+}  // namespace math
+}  // namespace ekumen
@@ -0,0 +1,46 @@
+#pragma once
+
+// Standard libraries
+#include <cstddef>
+#include <cstdint>
+
+#include "isometry.h"
+#include "transform_kernels.h"
+
+namespace ekumen {
+namespace math {
+
+// Batched Matrix3 kernels over packed arrays of matrices, each one nine row-major scalars as
+// Matrix3T lays them out in memory. Matrices are processed in lane groups of two doubles or
+// four floats, one 128-bit register per component, at every vector level. Each group is
+// loaded component by component into vector registers, so every lane runs the exact
+// operations of the Matrix3T member the kernel replaces. In the default build results match
+// that member bit for bit. CPPCOURSE_FMA builds fuse Matrix3T::det(), which these kernels do
+// not, so they agree only to rounding there.
+//
+// Kernels taking a SimdLevel throw std::invalid_argument if the running CPU does not support
+// it. The others use DetectSimdLevel().
+
+// Number of uint64_t words in the singular mask of |count| matrices.
+constexpr size_t SingularMaskWords(size_t count) {
+    return (count + 63) / 64;
+}
+
+// Writes matrices[i].inverse() into out[i]. Matrices that Matrix3T::inverse() would reject as
+// singular do not throw: out[i] is set to zero and bit i % 64 of singular[i / 64] is set.
+// |singular| may be null, otherwise it must hold SingularMaskWords(count) words, which are
+// overwritten. |out| may alias |matrices|. Returns the number of singular matrices.
+size_t InverseBatch(SimdLevel level, const Matrix3* matrices, Matrix3* out, size_t count, uint64_t* singular);
+size_t InverseBatch(const Matrix3* matrices, Matrix3* out, size_t count, uint64_t* singular);
+size_t InverseBatch(SimdLevel level, const Matrix3f* matrices, Matrix3f* out, size_t count, uint64_t* singular);
+size_t InverseBatch(const Matrix3f* matrices, Matrix3f* out, size_t count, uint64_t* singular);
+
+// Writes a[i].product(b[i]) into out[i]. Note that Matrix3T::operator* multiplies element by
+// element, this is the matrix product. |out| may alias |a| or |b|.
+void ProductBatch(SimdLevel level, const Matrix3* a, const Matrix3* b, Matrix3* out, size_t count);
+void ProductBatch(const Matrix3* a, const Matrix3* b, Matrix3* out, size_t count);
+void ProductBatch(SimdLevel level, const Matrix3f* a, const Matrix3f* b, Matrix3f* out, size_t count);
+void ProductBatch(const Matrix3f* a, const Matrix3f* b, Matrix3f* out, size_t count);
+
+}  // namespace math
+}  // namespace ekumen
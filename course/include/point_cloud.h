@@ -0,0 +1,202 @@
+#pragma once
+
+// Standard libraries
+#include <cstddef>
+#include <cstdlib>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+#include "isometry.h"
+
+namespace ekumen {
+namespace math {
+
+// Allocator returning |Alignment| aligned storage, so every coordinate array starts on a cache
+// line and vector kernels never split their first loads.
+template <class T, size_t Alignment = 64>
+struct AlignedAllocator {
+    using value_type = T;
+    template <class U>
+    struct rebind {
+        using other = AlignedAllocator<U, Alignment>;
+    };
+
+    AlignedAllocator() = default;
+    template <class U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment>&) {};
+
+    T* allocate(size_t count) {
+        void* pointer = nullptr;
+        if (posix_memalign(&pointer, Alignment, count * sizeof(T)) != 0) {
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(pointer);
+    };
+    void deallocate(T* pointer, size_t) { std::free(pointer); };
+
+    template <class U>
+    bool operator==(const AlignedAllocator<U, Alignment>&) const { return true; };
+    template <class U>
+    bool operator!=(const AlignedAllocator<U, Alignment>&) const { return false; };
+};
+
+template <class T>
+using AlignedVector = std::vector<T, AlignedAllocator<T>>;
+
+// Collection of points stored as a struct of arrays: one contiguous, aligned array per
+// coordinate plus optional per-point attributes. Whole-cloud operations stream through memory
+// and map directly onto the SIMD kernels in transform_kernels.h.
+//
+// Iterating yields Vector3T values (const) or PointRef views that read and write the
+// coordinate arrays in place.
+template <class T>
+class PointCloudT {
+    public:
+        using Scalar = T;
+
+        // View of one point. Reads and assignments go straight to the cloud's arrays.
+        class PointRef {
+            public:
+                PointRef(PointCloudT<T>* cloud, size_t index) : cloud_(cloud), index_(index) {};
+
+                T& x() const { return cloud_->x_[index_]; };
+                T& y() const { return cloud_->y_[index_]; };
+                T& z() const { return cloud_->z_[index_]; };
+                operator Vector3T<T>() const { return Vector3T<T>(x(), y(), z()); };
+                const PointRef& operator=(const Vector3T<T>& point) const {
+                    x() = point.x();
+                    y() = point.y();
+                    z() = point.z();
+                    return *this;
+                };
+                const PointRef& operator=(const PointRef& other) const {
+                    return *this = static_cast<Vector3T<T>>(other);
+                };
+                // Swaps the points, not the views, so algorithms like std::reverse work.
+                friend void swap(const PointRef& a, const PointRef& b) {
+                    const Vector3T<T> point = a;
+                    a = b;
+                    b = point;
+                };
+
+            private:
+                PointCloudT<T>* cloud_;
+                size_t index_;
+        };
+
+        // Random access iterator over point views. Like std::vector<bool>, dereferencing
+        // returns a proxy rather than a reference.
+        template <bool Const>
+        class IteratorT {
+            public:
+                using Cloud = typename std::conditional<Const, const PointCloudT<T>, PointCloudT<T>>::type;
+                using iterator_category = std::random_access_iterator_tag;
+                using value_type = Vector3T<T>;
+                using difference_type = std::ptrdiff_t;
+                using reference = typename std::conditional<Const, Vector3T<T>, PointRef>::type;
+                using pointer = void;
+
+                IteratorT(Cloud* cloud, size_t index) : cloud_(cloud), index_(index) {};
+
+                reference operator*() const { return (*cloud_)[index_]; };
+                reference operator[](difference_type offset) const { return (*cloud_)[index_ + offset]; };
+                IteratorT& operator++() {
+                    ++index_;
+                    return *this;
+                };
+                IteratorT operator++(int) { return IteratorT(cloud_, index_++); };
+                IteratorT& operator--() {
+                    --index_;
+                    return *this;
+                };
+                IteratorT operator--(int) { return IteratorT(cloud_, index_--); };
+                IteratorT& operator+=(difference_type offset) {
+                    index_ += offset;
+                    return *this;
+                };
+                IteratorT& operator-=(difference_type offset) {
+                    index_ -= offset;
+                    return *this;
+                };
+                IteratorT operator+(difference_type offset) const { return IteratorT(cloud_, index_ + offset); };
+                IteratorT operator-(difference_type offset) const { return IteratorT(cloud_, index_ - offset); };
+                difference_type operator-(const IteratorT& other) const {
+                    return static_cast<difference_type>(index_) - static_cast<difference_type>(other.index_);
+                };
+                bool operator==(const IteratorT& other) const { return index_ == other.index_; };
+                bool operator!=(const IteratorT& other) const { return index_ != other.index_; };
+                bool operator<(const IteratorT& other) const { return index_ < other.index_; };
+                bool operator>(const IteratorT& other) const { return index_ > other.index_; };
+                bool operator<=(const IteratorT& other) const { return index_ <= other.index_; };
+                bool operator>=(const IteratorT& other) const { return index_ >= other.index_; };
+                friend IteratorT operator+(difference_type offset, const IteratorT& iterator) {
+                    return iterator + offset;
+                };
+
+            private:
+                Cloud* cloud_;
+                size_t index_;
+        };
+        using iterator = IteratorT<false>;
+        using const_iterator = IteratorT<true>;
+
+        PointCloudT() = default;
+        explicit PointCloudT(size_t size) { resize(size); };
+
+        size_t size() const { return x_.size(); };
+        bool empty() const { return x_.empty(); };
+        void reserve(size_t size);
+        // New points start at the origin with zeroed attributes.
+        void resize(size_t size);
+        void clear() { resize(0); };
+        void push_back(const Vector3T<T>& point);
+
+        PointRef operator[](size_t index) { return PointRef(this, index); };
+        Vector3T<T> operator[](size_t index) const { return Vector3T<T>(x_[index], y_[index], z_[index]); };
+        iterator begin() { return iterator(this, 0); };
+        iterator end() { return iterator(this, size()); };
+        const_iterator begin() const { return const_iterator(this, 0); };
+        const_iterator end() const { return const_iterator(this, size()); };
+
+        // Coordinate arrays, aligned to 64 bytes.
+        T* x() { return x_.data(); };
+        T* y() { return y_.data(); };
+        T* z() { return z_.data(); };
+        const T* x() const { return x_.data(); };
+        const T* y() const { return y_.data(); };
+        const T* z() const { return z_.data(); };
+
+        // Optional attributes. Enabling one sizes it to the cloud, zero filled, and from then on
+        // it grows and shrinks with the points. Accessors must only be used while enabled.
+        void enableIntensity() { intensity_enabled_ = true; intensity_.resize(size(), 0.f); };
+        void enableTimestamp() { timestamp_enabled_ = true; timestamp_.resize(size(), 0.); };
+        bool hasIntensity() const { return intensity_enabled_; };
+        bool hasTimestamp() const { return timestamp_enabled_; };
+        float* intensity() { return intensity_.data(); };
+        const float* intensity() const { return intensity_.data(); };
+        // Seconds.
+        double* timestamp() { return timestamp_.data(); };
+        const double* timestamp() const { return timestamp_.data(); };
+
+        // Applies |isometry| to every point in place with the SIMD kernels. Attributes are
+        // left untouched.
+        void transform(const IsometryT<T>& isometry);
+        PointCloudT<T> transformed(const IsometryT<T>& isometry) const;
+
+    private:
+        AlignedVector<T> x_;
+        AlignedVector<T> y_;
+        AlignedVector<T> z_;
+        AlignedVector<float> intensity_;
+        AlignedVector<double> timestamp_;
+        bool intensity_enabled_{false};
+        bool timestamp_enabled_{false};
+};
+
+using PointCloud = PointCloudT<double>;
+using PointCloudf = PointCloudT<float>;
+
+}  // namespace math
+}  // namespace ekumen
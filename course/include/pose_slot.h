@@ -0,0 +1,53 @@
+#pragma once
+
+// Standard libraries
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "isometry.h"
+
+namespace ekumen {
+namespace math {
+
+// Holds the latest pose of a frame, published by writer threads and read by any number of
+// reader threads without locks.
+//
+// The slot is a sequence lock: the pose is stored as twelve atomic words guarded by a
+// sequence counter that is odd while a write is in progress. Readers copy the words and
+// retry if the counter moved, so they always return a pose that was published as a whole
+// and never make a writer wait. Concurrent writers are serialized among themselves on the
+// counter. Readers only retry while a write overlaps them, so with poses published at sensor
+// rates a read almost always completes in one pass; a reader that keeps failing yields its
+// core in case the writer was descheduled mid-publish.
+class PoseSlot {
+    public:
+        // Starts out holding the identity.
+        PoseSlot();
+        explicit PoseSlot(const Isometry& pose);
+
+        PoseSlot(const PoseSlot&) = delete;
+        PoseSlot& operator=(const PoseSlot&) = delete;
+
+        // Replaces the held pose. Safe to call from several threads at once.
+        void publish(const Isometry& pose);
+
+        // Returns a consistent snapshot of the latest published pose.
+        Isometry read() const;
+        // Same as read(), also returning the number of publish() calls the snapshot reflects.
+        Isometry read(uint64_t* version) const;
+
+        // Number of completed publish() calls.
+        uint64_t version() const { return sequence_.load(std::memory_order_acquire) / 2; };
+
+    private:
+        // Nine rotation values in row-major order followed by the translation.
+        static constexpr size_t kWords{12};
+
+        // Keeps the counter and the pose away from unrelated data written by other cores.
+        alignas(64) std::atomic<uint64_t> sequence_{0};
+        std::atomic<uint64_t> words_[kWords];
+};
+
+}  // namespace math
+}  // namespace ekumen
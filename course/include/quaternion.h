@@ -0,0 +1,89 @@
+#pragma once
+
+// Standard libraries
+#include <iostream>
+
+#include "isometry.h"
+
+namespace ekumen {
+namespace math {
+
+// Rotation quaternion w + xi + yj + zk. Rotation helpers assume a unit quaternion.
+class Quaternion {
+    public:
+        // Identity rotation.
+        Quaternion() : w_(1.), x_(0.), y_(0.), z_(0.) {};
+        Quaternion(const double w, const double x, const double y, const double z) : w_(w), x_(x), y_(y), z_(z) {};
+
+        // Getters.
+        double w() const { return w_; };
+        double x() const { return x_; };
+        double y() const { return y_; };
+        double z() const { return z_; };
+
+        // Setters.
+        double& w() { return w_; };
+        double& x() { return x_; };
+        double& y() { return y_; };
+        double& z() { return z_; };
+
+        // Hamilton product: rotates by |quaternion| first, then by *this.
+        Quaternion operator*(const Quaternion& quaternion) const;
+        bool operator==(const Quaternion& quaternion) const;
+        bool operator!=(const Quaternion& quaternion) const;
+        double dot(const Quaternion& quaternion) const;
+        double norm() const;
+        Quaternion conjugate() const;
+        Quaternion normalized() const;
+        // Rescales to unit norm, undoing the drift accumulated by long chains of products.
+        void normalize();
+        Vector3 rotate(const Vector3& vector) const;
+        Matrix3 toMatrix() const;
+
+        static Quaternion FromAxisAngle(const Vector3& axis, const double angle);
+        // |rotation| must be orthonormal.
+        static Quaternion FromMatrix(const Matrix3& rotation);
+        // Spherical linear interpolation between unit quaternions, |t| in [0, 1]. Follows the
+        // shortest arc, so the result may be the negated form of |to| at t = 1.
+        static Quaternion Slerp(const Quaternion& from, const Quaternion& to, const double t);
+
+    private:
+        double w_, x_, y_, z_;
+};
+
+inline std::ostream& operator<<(std::ostream& os, const Quaternion& quaternion) {
+    return os << "(w: " << quaternion.w() << ", x: " << quaternion.x() << ", y: " << quaternion.y()
+              << ", z: " << quaternion.z() << ")";
+}
+
+// Rigid transform stored as a unit quaternion plus a translation: 7 doubles instead of
+// Isometry's 12, and composition costs two quaternion operations instead of a 3x3 product.
+class QuaternionIsometry {
+    public:
+        QuaternionIsometry() : rotation_(), translation_() {};
+        QuaternionIsometry(const Vector3& translation, const Quaternion& rotation)
+            : rotation_(rotation), translation_(translation) {};
+        explicit QuaternionIsometry(const Isometry& isometry)
+            : rotation_(Quaternion::FromMatrix(isometry.rotation())), translation_(isometry.translation()) {};
+
+        const Quaternion& rotation() const { return rotation_; };
+        const Vector3& translation() const { return translation_; };
+
+        QuaternionIsometry compose(const QuaternionIsometry& isometry) const { return *this * isometry; };
+        QuaternionIsometry inverse() const;
+        Vector3 transform(const Vector3& vector) const { return rotation_.rotate(vector) + translation_; };
+        // Renormalizes the rotation. Cheap enough to call after every few thousand compositions.
+        void normalize() { rotation_.normalize(); };
+        Isometry toIsometry() const { return Isometry(translation_, rotation_.toMatrix()); };
+
+        // Operators
+        Vector3 operator*(const Vector3& vector) const { return transform(vector); };
+        QuaternionIsometry operator*(const QuaternionIsometry& isometry) const;
+
+    private:
+        Quaternion rotation_;
+        Vector3 translation_;
+};
+
+}  // namespace math
+}  // namespace ekumen
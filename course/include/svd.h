@@ -0,0 +1,73 @@
+#pragma once
+
+// Standard libraries
+#include <cstddef>
+
+#include "isometry.h"
+
+namespace ekumen {
+namespace math {
+
+// Singular value decomposition A = U * diag(values) * V^T, with U and V proper rotations
+// (det +1). Singular values are sorted by decreasing magnitude and only the last one may be
+// negative, carrying the sign of det(A). This signed convention keeps U and V rotations, which
+// is what the nearest rotation needs.
+template <class T>
+struct SvdT {
+    Matrix3T<T> u;
+    Vector3T<T> values;
+    Matrix3T<T> v;
+};
+
+using Svd = SvdT<double>;
+using Svdf = SvdT<float>;
+
+// Polar decomposition A = rotation * stretch, with |rotation| the rotation nearest to A in the
+// Frobenius norm and |stretch| symmetric.
+template <class T>
+struct PolarT {
+    Matrix3T<T> rotation;
+    Matrix3T<T> stretch;
+};
+
+using Polar = PolarT<double>;
+using Polarf = PolarT<float>;
+
+// Follows McAdams et al., "Computing the Singular Value Decomposition of 3x3 matrices with
+// minimal branching and elementary floating point operations": V diagonalizes A^T * A with the
+// Jacobi solver of symmetric_eigen.h, then Givens rotations reduce A * V to upper triangular
+// form, whose diagonal holds the singular values and whose rotations make up U. Squaring A
+// costs V accuracy when the singular values spread, so one sweep of one-sided Jacobi
+// orthogonalizes the columns of A * V before the QR step.
+//
+// Every stage runs on groups of matrices in lockstep, a single call being a group of one. A
+// lane that needs no rotation gets the identity rather than a branch of its own, so the
+// compiler vectorizes the lanes. Unlike the McAdams kernel, the rotations use exact square
+// roots and divisions rather than approximate reciprocal square roots, and the eigen stage
+// iterates to convergence rather than a fixed number of sweeps.
+//
+// Accuracy, with eps the machine epsilon of T: ||A - U * diag(values) * V^T|| is within
+// 16 * eps * ||A||, rank deficient matrices included, and U and V are orthonormal to within
+// 16 * eps. Singular values are accurate to about eps * ||A|| in absolute terms. This holds
+// over the whole range of T: a matrix whose largest element is far from 1 is scaled by a power
+// of two first, exactly, and its singular values scaled back. Only singular values beyond the
+// largest finite T overflow.
+template <class T>
+SvdT<T> ComputeSvd(const Matrix3T<T>& matrix);
+
+// Writes ComputeSvd(matrices[i]) into out[i], identical to single calls up to the sign of zeros.
+// Decomposes A^T * A through EigenDecomposeBatch(), then finishes the matrices in lockstep
+// groups.
+template <class T>
+void ComputeSvdBatch(const Matrix3T<T>* matrices, SvdT<T>* out, size_t count);
+
+template <class T>
+PolarT<T> PolarDecompose(const Matrix3T<T>& matrix);
+
+// Rotation nearest to |matrix|, U * V^T. Projects a rotation that drifted off SO(3) after long
+// chains of products back onto it.
+template <class T>
+Matrix3T<T> NearestRotation(const Matrix3T<T>& matrix);
+
+}  // namespace math
+}  // namespace ekumen
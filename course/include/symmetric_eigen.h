@@ -0,0 +1,47 @@
+#pragma once
+
+// Standard libraries
+#include <cstddef>
+
+#include "isometry.h"
+
+namespace ekumen {
+namespace math {
+
+// Eigen-decomposition of a symmetric matrix A: A = V * diag(values) * V^T.
+template <class T>
+struct EigenDecompositionT {
+    // Eigenvalues in ascending order.
+    Vector3T<T> values;
+    // Column i is the unit eigenvector of values[i]. The columns are orthonormal and V is a
+    // proper rotation (det +1), so the principal axes of a covariance can be used directly as
+    // the rotation of an Isometry. For a covariance, col(0) is the surface normal estimate.
+    Matrix3T<T> vectors;
+};
+
+using EigenDecomposition = EigenDecompositionT<double>;
+using EigenDecompositionf = EigenDecompositionT<float>;
+
+// Cyclic Jacobi eigen-solver for symmetric matrices such as covariances and inertia tensors.
+// Only the upper triangle of |matrix| is read. Rotations are applied until the off-diagonal
+// elements are negligible against the diagonal. Convergence is quadratic, so a 3x3 matrix
+// takes a handful of sweeps.
+//
+// Accuracy, with eps the machine epsilon of T and ||A|| the Frobenius norm of the matrix:
+// - every eigenvalue is within 8 * eps * ||A|| of the exact one, including the small ones
+//   near zero that plane normals rely on;
+// - ||A * v - value * v|| is within 8 * eps * ||A|| for every eigenpair;
+// - the columns of V are orthonormal to within 8 * eps.
+// These hold at any scale whose elements are normal numbers. Squares of elements that could
+// overflow or underflow are avoided or recomputed scaled.
+// Eigenvectors of eigenvalues closer than about eps * ||A|| to another are not individually
+// determined: any orthonormal basis of their shared subspace is a valid answer.
+template <class T>
+EigenDecompositionT<T> EigenDecompose(const Matrix3T<T>& matrix);
+
+// Writes EigenDecompose(matrices[i]) into out[i], without per-call overhead.
+template <class T>
+void EigenDecomposeBatch(const Matrix3T<T>* matrices, EigenDecompositionT<T>* out, size_t count);
+
+}  // namespace math
+}  // namespace ekumen
@@ -0,0 +1,64 @@
+#pragma once
+
+// Standard libraries
+#include <cstddef>
+
+namespace ekumen {
+namespace math {
+
+template <class T>
+class Vector3T;
+template <class T>
+class Matrix3T;
+template <class T>
+class IsometryT;
+
+// Lossless text form of scalars, vectors, matrices and isometries.
+//
+// Scalars are written with Grisu3, falling back to exact arithmetic where it cannot decide. The
+// text parses back to the same value and has the fewest significant digits that do, the
+// closest to the value if several are that short: 0.1 is "0.1", 1 is "1" and 1e-7 is "1e-07".
+// Numbers whose decimal point falls within 17 digits of the leading digit are written in
+// fixed notation, anything else in scientific notation. Infinities are "inf" and "-inf", NaNs
+// are "nan".
+//
+// Nothing goes through iostreams or the C locale. Formatters write into a caller buffer of at
+// least the matching kMax*Chars size and return the end of the text, without a terminating
+// null. Parsers read [begin, end), skip blanks before each number and punctuation mark, and
+// return the end of the parsed text, or nullptr without touching the output if the text is
+// malformed.
+
+// Longest scalar, e.g. "-2.2250738585072014e-308".
+constexpr size_t kMaxScalarChars{24};
+// "(x: " X ", y: " Y ", z: " Z ")"
+constexpr size_t kMaxVector3Chars{15 + 3 * kMaxScalarChars};
+// "[[" 3 scalars "], [" 3 scalars "], [" 3 scalars "]]", with ", " between scalars.
+constexpr size_t kMaxMatrix3Chars{24 + 9 * kMaxScalarChars};
+// "[T: " translation ", R:" rotation "]"
+constexpr size_t kMaxIsometryChars{9 + kMaxVector3Chars + kMaxMatrix3Chars};
+
+char* FormatScalar(double value, char* buffer);
+char* FormatScalar(float value, char* buffer);
+const char* ParseScalar(const char* begin, const char* end, double* value);
+const char* ParseScalar(const char* begin, const char* end, float* value);
+
+// Same layout as the stream operators: "(x: 1, y: 2, z: 3)".
+template <class T>
+char* Format(const Vector3T<T>& vector, char* buffer);
+// "[[1, 0, 0], [0, 1, 0], [0, 0, 1]]"
+template <class T>
+char* Format(const Matrix3T<T>& matrix, char* buffer);
+// "[T: (x: 1, y: 2, z: 3), R:[[1, 0, 0], [0, 1, 0], [0, 0, 1]]]"
+template <class T>
+char* Format(const IsometryT<T>& isometry, char* buffer);
+
+template <class T>
+const char* Parse(const char* begin, const char* end, Vector3T<T>* vector);
+template <class T>
+const char* Parse(const char* begin, const char* end, Matrix3T<T>* matrix);
+// Text whose rotation is not orthonormal within IsometryT<T>::kOrthonormalTolerance is malformed.
+template <class T>
+const char* Parse(const char* begin, const char* end, IsometryT<T>* isometry);
+
+}  // namespace math
+}  // namespace ekumen
@@ -0,0 +1,73 @@
+#pragma once
+
+// Standard libraries
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ekumen {
+namespace math {
+
+// Fixed set of worker threads with one task deque each. Workers run their own tasks newest
+// first and, when they run dry, steal the oldest task of another worker, so uneven work
+// spreads out without a shared queue every thread contends on.
+class ThreadPool {
+    public:
+        // Starts |threads| workers. Zero picks std::thread::hardware_concurrency().
+        explicit ThreadPool(size_t threads = 0);
+        // Finishes the queued tasks, then joins the workers.
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        size_t size() const { return workers_.size(); };
+
+        // Runs |task|(i) for every i in [0, |count|) and returns once all of them finished. The
+        // calling thread runs tasks too, so calling this from inside a task does not deadlock.
+        // If tasks throw, the first exception is rethrown here after the others finished.
+        void parallelFor(size_t count, const std::function<void(size_t)>& task);
+
+    private:
+        // Tracks the tasks of one parallelFor() call.
+        struct Group {
+            std::atomic<size_t> remaining{0};
+            std::mutex mutex;
+            std::condition_variable finished;
+            std::exception_ptr error;
+        };
+
+        struct Task {
+            std::function<void()> run;
+            Group* group;
+        };
+
+        struct Queue {
+            std::mutex mutex;
+            std::deque<Task> tasks;
+        };
+
+        void workerLoop(size_t index);
+        // Pops a task from queue |index|, or steals one from another queue. Returns false if
+        // every queue is empty.
+        bool takeTask(size_t index, Task* task);
+        void runTask(Task& task);
+
+        std::vector<std::unique_ptr<Queue>> queues_;
+        std::vector<std::thread> workers_;
+        // Guards sleeping and waking up idle workers.
+        std::mutex idle_mutex_;
+        std::condition_variable idle_;
+        std::atomic<size_t> queued_{0};
+        bool stopping_{false};
+};
+
+}  // namespace math
+}  // namespace ekumen
@@ -0,0 +1,26 @@
+#pragma once
+
+// Standard libraries
+#include <cstddef>
+
+#include "isometry.h"
+#include "thread_pool.h"
+
+namespace ekumen {
+namespace math {
+
+// Integrates relative motion: writes poses[i] = steps[0] * steps[1] * ... * steps[i] for every
+// i in [0, |count|). |poses| may alias |steps|.
+void PrefixCompose(const Isometry* steps, Isometry* poses, size_t count);
+
+// Same as above, computed as a parallel prefix scan on |pool|. The chain is cut into blocks:
+// each block's product is reduced in parallel, the block products are scanned serially, and
+// then every block is scanned in parallel starting from the pose before it. That is about
+// twice the multiplies of the serial loop, so it pays off from three cores on. Products are
+// grouped differently than in the serial loop, so results match it within rounding rather
+// than bit for bit. Inputs below |min_parallel_count| steps run serially.
+void PrefixCompose(ThreadPool& pool, const Isometry* steps, Isometry* poses, size_t count,
+                   size_t min_parallel_count = 65536);
+
+}  // namespace math
+}  // namespace ekumen
@@ -0,0 +1,74 @@
+#pragma once
+
+// Standard libraries
+#include <cstddef>
+#include <vector>
+
+#include "isometry.h"
+#include "quaternion.h"
+
+namespace ekumen {
+namespace math {
+
+// History of one frame edge: a ring buffer of time stamped transforms answering queries at
+// arbitrary times. Between two samples the translation is interpolated linearly and the
+// rotation with Quaternion::Slerp.
+//
+// Memory is bounded: the buffer never holds more than |capacity| samples, and samples older
+// than |retention| seconds before the newest one are dropped on insert. Lookups binary search
+// the history, so they cost O(log n) in the number of samples held.
+class TransformBuffer {
+    public:
+        // Throws std::invalid_argument if |capacity| is zero or |retention| is negative.
+        TransformBuffer(size_t capacity, double retention);
+
+        // Appends |transform| at |stamp| seconds. Stamps must be finite and strictly increasing;
+        // throws std::invalid_argument otherwise. |transform| must have an orthonormal rotation.
+        void insert(double stamp, const Isometry& transform);
+
+        // Returns the transform at |stamp|, interpolating between the samples around it. Throws
+        // std::out_of_range if |stamp| is outside [oldest(), newest()] or the buffer is empty.
+        Isometry lookup(double stamp) const;
+        // Same as lookup(), keeping the rotation as a quaternion.
+        QuaternionIsometry lookupQuaternion(double stamp) const;
+
+        // Stamps of the oldest and newest samples held. Throw std::out_of_range when empty.
+        double oldest() const;
+        double newest() const;
+
+        bool empty() const { return size_ == 0; };
+        size_t size() const { return size_; };
+        size_t capacity() const { return samples_.size(); };
+        double retention() const { return retention_; };
+        void clear() {
+            head_ = 0;
+            size_ = 0;
+        };
+
+    private:
+        struct Sample {
+            double stamp{0.};
+            QuaternionIsometry transform;
+        };
+
+        // Returns the |index|-th oldest sample held.
+        // Both indices are below the capacity, so one conditional subtraction replaces a modulo
+        // on the binary search path.
+        const Sample& at(size_t index) const {
+            const size_t slot = head_ + index;
+            return samples_[slot < samples_.size() ? slot : slot - samples_.size()];
+        };
+        void dropOldest() {
+            head_ = head_ + 1 == samples_.size() ? 0 : head_ + 1;
+            --size_;
+        };
+
+        std::vector<Sample> samples_;
+        double retention_;
+        // Index of the oldest sample in |samples_|.
+        size_t head_{0};
+        size_t size_{0};
+};
+
+}  // namespace math
+}  // namespace ekumen
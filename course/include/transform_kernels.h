@@ -0,0 +1,48 @@
+#pragma once
+
+// Standard libraries
+#include <cstddef>
+
+namespace ekumen {
+namespace math {
+
+// Instruction sets with a dedicated bulk transform kernel.
+enum class SimdLevel {
+    kScalar,
+    kSse42,
+    kAvx2,
+    kNeon,
+};
+
+// Returns a printable name for |level|.
+const char* ToString(SimdLevel level);
+
+// Returns true when the running CPU can execute the |level| kernel.
+bool IsSupported(SimdLevel level);
+
+// Returns the widest kernel supported by the running CPU. Detected once and cached.
+SimdLevel DetectSimdLevel();
+
+// Applies |rotation| (nine row-major values) followed by |translation| to |count| points
+// stored as separate x, y and z arrays, writing into the |out_*| arrays. Output arrays may
+// alias the input arrays.
+//
+// Every kernel evaluates r0 * x + r1 * y + r2 * z + t in that order with separate multiplies
+// and adds (no fused multiply-add), so all of them match the scalar kernel bit for bit.
+// Throws std::invalid_argument if |level| is not supported by the running CPU.
+void TransformSoA(SimdLevel level, const double rotation[9], const double translation[3], const double* x,
+                  const double* y, const double* z, double* out_x, double* out_y, double* out_z, size_t count);
+
+// Same as above, using the kernel picked by DetectSimdLevel().
+void TransformSoA(const double rotation[9], const double translation[3], const double* x, const double* y,
+                  const double* z, double* out_x, double* out_y, double* out_z, size_t count);
+
+// Single precision versions of the above. The vector kernels process twice as many points per
+// instruction as their double counterparts.
+void TransformSoA(SimdLevel level, const float rotation[9], const float translation[3], const float* x,
+                  const float* y, const float* z, float* out_x, float* out_y, float* out_z, size_t count);
+void TransformSoA(const float rotation[9], const float translation[3], const float* x, const float* y,
+                  const float* z, float* out_x, float* out_y, float* out_z, size_t count);
+
+}  // namespace math
+}  // namespace ekumen
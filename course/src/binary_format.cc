@@ -0,0 +1,322 @@
+#include "binary_format.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+namespace ekumen {
+namespace math {
+namespace {
+
+static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__,
+              "Binary files are little-endian and read in place, which needs a little-endian host");
+
+constexpr char kMagic[8]{'E', 'K', 'U', 'M', 'A', 'T', 'H', '\0'};
+constexpr size_t kAlignment{64};
+constexpr size_t kPoseWords{12};
+
+enum Kind : uint32_t {
+    kTrajectory = 1,
+    kPointCloud = 2,
+};
+
+enum Attributes : uint32_t {
+    kIntensity = 1 << 0,
+    kTimestamp = 1 << 1,
+};
+
+struct FileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t kind;
+    uint32_t scalar_size;
+    uint32_t attributes;
+    uint64_t count;
+    uint8_t padding[32];
+};
+static_assert(sizeof(FileHeader) == kAlignment, "The header must keep the data after it aligned");
+
+FileHeader MakeHeader(const Kind kind, const uint32_t scalar_size, const uint32_t attributes, const uint64_t count) {
+    FileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kBinaryFormatVersion;
+    header.kind = kind;
+    header.scalar_size = scalar_size;
+    header.attributes = attributes;
+    header.count = count;
+    return header;
+}
+
+// Checks the header of |file| and returns it.
+FileHeader ReadHeader(const MappedFile& file, const std::string& path, const Kind kind, const uint32_t scalar_size) {
+    FileHeader header;
+    if (file.size() < sizeof(header)) {
+        throw std::runtime_error(path + " is too small to be a binary file");
+    }
+    std::memcpy(&header, file.data(), sizeof(header));
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0) {
+        throw std::runtime_error(path + " is not a binary file");
+    }
+    if (header.version != kBinaryFormatVersion) {
+        throw std::runtime_error(path + " has unsupported format version " + std::to_string(header.version));
+    }
+    if (header.kind != kind) {
+        throw std::runtime_error(path + " holds a different kind of data");
+    }
+    if (header.scalar_size != scalar_size) {
+        throw std::runtime_error(path + " holds " + std::to_string(header.scalar_size) + " byte scalars, expected " +
+                                 std::to_string(scalar_size));
+    }
+    return header;
+}
+
+// Kept out of line so the string building stays off the hot path of TrajectoryReader::pose().
+[[noreturn]] __attribute__((noinline, cold)) void ThrowInvalidPose(const size_t index) {
+    throw std::runtime_error("Pose " + std::to_string(index) + " of the trajectory is not a rigid transform");
+}
+
+size_t AlignUp(const size_t offset) {
+    return (offset + kAlignment - 1) / kAlignment * kAlignment;
+}
+
+// Byte offsets of the point cloud sections. Each one starts where the previous one ends,
+// rounded up to the alignment.
+struct CloudLayout {
+    CloudLayout(const uint64_t count, const size_t scalar_size, const uint32_t attributes) {
+        const size_t coordinates = AlignUp(count * scalar_size);
+        x = sizeof(FileHeader);
+        y = x + coordinates;
+        z = y + coordinates;
+        intensity = z + coordinates;
+        timestamp = intensity + ((attributes & kIntensity) != 0 ? AlignUp(count * sizeof(float)) : 0);
+        end = timestamp + ((attributes & kTimestamp) != 0 ? AlignUp(count * sizeof(double)) : 0);
+    }
+
+    size_t x, y, z, intensity, timestamp, end;
+};
+
+void WriteOrThrow(std::FILE* file, const void* data, const size_t size, const std::string& path) {
+    if (size != 0 && std::fwrite(data, 1, size, file) != size) {
+        throw std::runtime_error("Could not write " + path);
+    }
+}
+
+// Writes |size| bytes of |data| followed by zeros up to the alignment.
+void WriteSection(std::FILE* file, const void* data, const size_t size, const std::string& path) {
+    static const uint8_t kZeros[kAlignment]{};
+    WriteOrThrow(file, data, size, path);
+    WriteOrThrow(file, kZeros, AlignUp(size) - size, path);
+}
+
+}  // namespace
+
+// TrajectoryWriter
+TrajectoryWriter::TrajectoryWriter(const std::string& path) : file_(std::fopen(path.c_str(), "wb")) {
+    if (file_ == nullptr) {
+        throw std::runtime_error("Could not open " + path + ": " + std::strerror(errno));
+    }
+    // The count is filled in by close().
+    const FileHeader header = MakeHeader(kTrajectory, sizeof(double), 0, 0);
+    if (std::fwrite(&header, sizeof(header), 1, file_) != 1) {
+        std::fclose(file_);
+        throw std::runtime_error("Could not write " + path);
+    }
+}
+
+TrajectoryWriter::~TrajectoryWriter() {
+    try {
+        close();
+    } catch (const std::runtime_error&) {
+    }
+}
+
+void TrajectoryWriter::append(const Isometry& pose) {
+    append(&pose, 1);
+}
+
+void TrajectoryWriter::append(const Isometry* poses, size_t count) {
+    if (file_ == nullptr) {
+        throw std::logic_error("TrajectoryWriter is closed");
+    }
+    // Records are packed into chunks so that each fwrite() call moves a few kilobytes.
+    constexpr size_t kChunkPoses{128};
+    double chunk[kChunkPoses * kPoseWords];
+    for (size_t begin = 0; begin < count; begin += kChunkPoses) {
+        const size_t end = std::min(count, begin + kChunkPoses);
+        double* record = chunk;
+        for (size_t i = begin; i < end; ++i, record += kPoseWords) {
+            const Matrix3& rotation = poses[i].rotation();
+            for (uint32_t row = 0; row < 3; ++row) {
+                for (int column = 0; column < 3; ++column) {
+                    record[3 * row + column] = rotation[row][column];
+                }
+                record[9 + row] = poses[i].translation()[row];
+            }
+        }
+        failed_ |= std::fwrite(chunk, kPoseWords * sizeof(double), end - begin, file_) != end - begin;
+    }
+    count_ += count;
+}
+
+void TrajectoryWriter::close() {
+    if (file_ == nullptr) {
+        return;
+    }
+    const FileHeader header = MakeHeader(kTrajectory, sizeof(double), 0, count_);
+    failed_ |= std::fseek(file_, 0, SEEK_SET) != 0;
+    failed_ |= std::fwrite(&header, sizeof(header), 1, file_) != 1;
+    failed_ |= std::fclose(file_) != 0;
+    file_ = nullptr;
+    if (failed_) {
+        throw std::runtime_error("Could not write the trajectory file");
+    }
+}
+
+// MappedFile
+MappedFile::MappedFile(const std::string& path) : data_(nullptr), size_(0) {
+    const int descriptor = ::open(path.c_str(), O_RDONLY);
+    if (descriptor < 0) {
+        throw std::runtime_error("Could not open " + path + ": " + std::strerror(errno));
+    }
+    struct stat status;
+    if (::fstat(descriptor, &status) != 0) {
+        ::close(descriptor);
+        throw std::runtime_error("Could not stat " + path + ": " + std::strerror(errno));
+    }
+    size_ = static_cast<size_t>(status.st_size);
+    // Mapping zero bytes fails, and an empty file is rejected by the readers anyway.
+    if (size_ != 0) {
+        void* mapping = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, descriptor, 0);
+        if (mapping == MAP_FAILED) {
+            ::close(descriptor);
+            throw std::runtime_error("Could not map " + path + ": " + std::strerror(errno));
+        }
+        data_ = static_cast<const uint8_t*>(mapping);
+    }
+    // The mapping stays valid after the descriptor is closed.
+    ::close(descriptor);
+}
+
+MappedFile::MappedFile(MappedFile&& other) : data_(other.data_), size_(other.size_) {
+    other.data_ = nullptr;
+    other.size_ = 0;
+}
+
+MappedFile::~MappedFile() {
+    if (data_ != nullptr) {
+        ::munmap(const_cast<uint8_t*>(data_), size_);
+    }
+}
+
+// TrajectoryReader
+TrajectoryReader::TrajectoryReader(const std::string& path) : file_(path) {
+    const FileHeader header = ReadHeader(file_, path, kTrajectory, sizeof(double));
+    constexpr size_t kRecordSize{kPoseWords * sizeof(double)};
+    if (header.count > (file_.size() - sizeof(header)) / kRecordSize) {
+        throw std::runtime_error(path + " is truncated");
+    }
+    count_ = header.count;
+    records_ = reinterpret_cast<const double*>(file_.data() + sizeof(header));
+}
+
+Isometry TrajectoryReader::pose(size_t index) const {
+    if (index >= count_) {
+        throw std::out_of_range("Pose " + std::to_string(index) + " is past the end of the trajectory");
+    }
+    const double* record = records_ + kPoseWords * index;
+    // The file is input, not an invariant: check what the Isometry constructor only asserts.
+    // isOrthonormal() rejects non-finite rotations, the translation is checked here. x * 0 is
+    // zero for every finite x and NaN otherwise.
+    const double non_finite = record[9] * 0. + record[10] * 0. + record[11] * 0.;
+    const Matrix3 rotation(Vector3(record[0], record[1], record[2]), Vector3(record[3], record[4], record[5]),
+                           Vector3(record[6], record[7], record[8]));
+    if (non_finite != 0. || !rotation.isOrthonormal(Isometry::kOrthonormalTolerance)) {
+        ThrowInvalidPose(index);
+    }
+    return Isometry(Vector3(record[9], record[10], record[11]), rotation);
+}
+
+// Point clouds
+template <class T>
+void WritePointCloud(const std::string& path, const PointCloudT<T>& cloud) {
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (file == nullptr) {
+        throw std::runtime_error("Could not open " + path + ": " + std::strerror(errno));
+    }
+    const uint32_t attributes = (cloud.hasIntensity() ? kIntensity : 0) | (cloud.hasTimestamp() ? kTimestamp : 0);
+    const FileHeader header = MakeHeader(kPointCloud, sizeof(T), attributes, cloud.size());
+    try {
+        WriteOrThrow(file, &header, sizeof(header), path);
+        WriteSection(file, cloud.x(), cloud.size() * sizeof(T), path);
+        WriteSection(file, cloud.y(), cloud.size() * sizeof(T), path);
+        WriteSection(file, cloud.z(), cloud.size() * sizeof(T), path);
+        if (cloud.hasIntensity()) {
+            WriteSection(file, cloud.intensity(), cloud.size() * sizeof(float), path);
+        }
+        if (cloud.hasTimestamp()) {
+            WriteSection(file, cloud.timestamp(), cloud.size() * sizeof(double), path);
+        }
+    } catch (const std::runtime_error&) {
+        std::fclose(file);
+        throw;
+    }
+    if (std::fclose(file) != 0) {
+        throw std::runtime_error("Could not write " + path);
+    }
+}
+
+template <class T>
+PointCloudReaderT<T>::PointCloudReaderT(const std::string& path) : file_(path) {
+    const FileHeader header = ReadHeader(file_, path, kPointCloud, sizeof(T));
+    // Rejects counts whose layout would overflow before comparing against the file size.
+    if (header.count > file_.size() / sizeof(T)) {
+        throw std::runtime_error(path + " is truncated");
+    }
+    const CloudLayout layout(header.count, sizeof(T), header.attributes);
+    if (layout.end > file_.size()) {
+        throw std::runtime_error(path + " is truncated");
+    }
+    count_ = header.count;
+    x_ = reinterpret_cast<const T*>(file_.data() + layout.x);
+    y_ = reinterpret_cast<const T*>(file_.data() + layout.y);
+    z_ = reinterpret_cast<const T*>(file_.data() + layout.z);
+    if ((header.attributes & kIntensity) != 0) {
+        intensity_ = reinterpret_cast<const float*>(file_.data() + layout.intensity);
+    }
+    if ((header.attributes & kTimestamp) != 0) {
+        timestamp_ = reinterpret_cast<const double*>(file_.data() + layout.timestamp);
+    }
+}
+
+template <class T>
+PointCloudT<T> PointCloudReaderT<T>::toPointCloud() const {
+    PointCloudT<T> cloud(count_);
+    std::copy(x_, x_ + count_, cloud.x());
+    std::copy(y_, y_ + count_, cloud.y());
+    std::copy(z_, z_ + count_, cloud.z());
+    if (intensity_ != nullptr) {
+        cloud.enableIntensity();
+        std::copy(intensity_, intensity_ + count_, cloud.intensity());
+    }
+    if (timestamp_ != nullptr) {
+        cloud.enableTimestamp();
+        std::copy(timestamp_, timestamp_ + count_, cloud.timestamp());
+    }
+    return cloud;
+}
+
+// Supported scalar types.
+template void WritePointCloud<double>(const std::string& path, const PointCloudT<double>& cloud);
+template void WritePointCloud<float>(const std::string& path, const PointCloudT<float>& cloud);
+template class PointCloudReaderT<double>;
+template class PointCloudReaderT<float>;
+
+}  // namespace math
+}  // namespace ekumen
@@ -0,0 +1,138 @@
+#include "frame_graph.h"
+
+#include <stdexcept>
+
+namespace ekumen {
+namespace math {
+namespace {
+
+const Isometry kIdentity{Isometry::FromTranslation(Vector3::kZero)};
+
+// Frame ids are dense indices, so two of them pack into one key as long as there are fewer
+// than 2^32 frames.
+uint64_t PairKey(FrameGraph::FrameId source, FrameGraph::FrameId target) {
+    return (static_cast<uint64_t>(source) << 32) | static_cast<uint64_t>(target);
+}
+
+}  // namespace
+
+constexpr FrameGraph::FrameId FrameGraph::kNoParent;
+
+FrameGraph::FrameId FrameGraph::addFrame(const std::string& name) {
+    return addFrame(name, kNoParent, kIdentity);
+}
+
+FrameGraph::FrameId FrameGraph::addFrame(const std::string& name, const std::string& parent,
+                                         const Isometry& parent_to_frame) {
+    return addFrame(name, id(parent), parent_to_frame);
+}
+
+FrameGraph::FrameId FrameGraph::addFrame(const std::string& name, FrameId parent, const Isometry& parent_to_frame) {
+    if (hasFrame(name)) {
+        throw std::invalid_argument("Frame already exists: " + name);
+    }
+    const FrameId frame_id = frames_.size();
+    const FrameId root = parent == kNoParent ? frame_id : frames_[parent].root;
+    frames_.emplace_back(name, parent, root, parent_to_frame);
+    // Roots are their own reference, so their root transform is always valid.
+    frames_.back().cached = parent == kNoParent;
+    if (parent != kNoParent) {
+        frames_[parent].children.push_back(frame_id);
+    }
+    ids_.emplace(name, frame_id);
+    return frame_id;
+}
+
+void FrameGraph::setTransform(const std::string& name, const Isometry& parent_to_frame) {
+    setTransform(id(name), parent_to_frame);
+}
+
+void FrameGraph::setTransform(FrameId id, const Isometry& parent_to_frame) {
+    Frame& updated = frame(id);
+    if (updated.parent == kNoParent) {
+        throw std::invalid_argument("Root frames have no parent transform: " + updated.name);
+    }
+    updated.parent_to_frame = parent_to_frame;
+    invalidate(id);
+}
+
+void FrameGraph::invalidate(FrameId id) {
+    // Only the subtree below the changed edge depends on it.
+    std::vector<FrameId>& pending = scratch_;
+    pending.assign(1, id);
+    while (!pending.empty()) {
+        Frame& stale = frames_[pending.back()];
+        pending.pop_back();
+        stale.cached = false;
+        ++stale.version;
+        pending.insert(pending.end(), stale.children.begin(), stale.children.end());
+    }
+}
+
+const Isometry& FrameGraph::rootTransform(FrameId id) const {
+    // Roots are always cached, so the walk up stops at the root at the latest.
+    std::vector<FrameId>& stale = scratch_;
+    stale.clear();
+    for (FrameId current = id; !frames_[current].cached; current = frames_[current].parent) {
+        stale.push_back(current);
+    }
+    for (auto it = stale.rbegin(); it != stale.rend(); ++it) {
+        Frame& current = frames_[*it];
+        current.root_to_frame = frames_[current.parent].root_to_frame * current.parent_to_frame;
+        current.cached = true;
+    }
+    return frames_[id].root_to_frame;
+}
+
+Isometry FrameGraph::transform(const std::string& source, const std::string& target) const {
+    return transform(id(source), id(target));
+}
+
+Isometry FrameGraph::transform(FrameId source, FrameId target) const {
+    const Frame& source_frame = frame(source);
+    const Frame& target_frame = frame(target);
+    if (source_frame.root != target_frame.root) {
+        throw std::invalid_argument("Frames " + source_frame.name + " and " + target_frame.name +
+                                    " are not connected");
+    }
+    if (source == target) {
+        return kIdentity;
+    }
+    const auto cached = pairs_.find(PairKey(source, target));
+    if (cached != pairs_.end() && cached->second.source_version == source_frame.version &&
+        cached->second.target_version == target_frame.version) {
+        return cached->second.target_to_source;
+    }
+    const Isometry target_to_source = rootTransform(target).inverse() * rootTransform(source);
+    const PairEntry entry{source_frame.version, target_frame.version, target_to_source};
+    if (cached != pairs_.end()) {
+        cached->second = entry;
+    } else {
+        pairs_.emplace(PairKey(source, target), entry);
+    }
+    return target_to_source;
+}
+
+FrameGraph::FrameId FrameGraph::id(const std::string& name) const {
+    const auto it = ids_.find(name);
+    if (it == ids_.end()) {
+        throw std::out_of_range("Unknown frame: " + name);
+    }
+    return it->second;
+}
+
+const std::string& FrameGraph::parent(const std::string& name) const {
+    static const std::string kNone;
+    const Frame& child = frames_[id(name)];
+    return child.parent == kNoParent ? kNone : frames_[child.parent].name;
+}
+
+FrameGraph::Frame& FrameGraph::frame(FrameId id) const {
+    if (id >= frames_.size()) {
+        throw std::out_of_range("Unknown frame id: " + std::to_string(id));
+    }
+    return frames_[id];
+}
+
+}  // namespace math
+}  // namespace ekumen
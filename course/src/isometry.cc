@@ -1,339 +1,67 @@
+#include <algorithm>
 #include <cmath>
 #include <cstdint>
+#include <limits>
 #include "isometry.h"
+#include "svd.h"
+#include "transform_kernels.h"
 
 namespace ekumen {
 namespace math {
 
-// Class constants
-const Vector3 Vector3::kUnitX = Vector3(1., 0., 0.);
-const Vector3 Vector3::kUnitY = Vector3(0., 1., 0.);
-const Vector3 Vector3::kUnitZ = Vector3(0., 0., 1.);
-const Vector3 Vector3::kZero = Vector3(0., 0., 0.);
-
-Vector3::Vector3(std::initializer_list<double> elements) : v_(new Elements{}){
-    if (elements.size() != 3) {
-        throw std::range_error("Elements out of range, Vector3 only have three elements");
-    }
-    auto it = elements.begin();
-    v_->x_ = *it++;
-    v_->y_ = *it++;
-    v_->z_ = *it++;
-}
-
-Vector3 Vector3::operator+(const Vector3& vector) const {
-    return Vector3(x() + vector.x(), y() + vector.y(), z() + vector.z());
-}
-
-Vector3 Vector3::operator-(const Vector3& vector) const {
-    return Vector3(x() - vector.x(), y() - vector.y(), z() - vector.z());
-}
-
-Vector3 Vector3::operator*(const double& value) const {
-    return Vector3(x() * value, y() * value, z() * value);
-}
-
-Vector3 Vector3::operator*(const Vector3& vector) const {
-    return Vector3(x() * vector.x(), y() * vector.y(), z() * vector.z());
-}
-
-Vector3 Vector3::operator/(const double& value) const {
-    return Vector3(x() / value, y() / value, z() / value);
-}
-
-Vector3 Vector3::operator/(const Vector3& vector) const {
-    return Vector3(x() / vector.x(), y() / vector.y(), z() / vector.z());
-}
-
-Vector3& Vector3::operator+=(const Vector3& vector) {
-    *this = *this + vector;
-    return *this;
-}
-
-Vector3& Vector3::operator-=(const Vector3& vector) {
-    *this = *this - vector;
-    return *this;
-}
-
-Vector3& Vector3::operator*=(const double& value) {
-    *this = *this * value;
-    return *this;
-}
-
-Vector3& Vector3::operator*=(const Vector3& vector) {
-    *this = *this * vector;
-    return *this;
-}
-
-Vector3& Vector3::operator/=(const Vector3& vector) {
-    *this = *this / vector;
-    return *this;
-}
-
-Vector3& Vector3::operator/=(const double& value) {
-    *this = *this / value;
-    return *this;
-}
-
-Vector3& Vector3::operator=(const Vector3& other) {
-    if (&other != this) {
-        delete v_;
-        v_ = new Elements{*(other.v_)};
-    }
-    return *this;
-};
-
-Vector3& Vector3::operator=(Vector3&& other) {
-    std::swap(v_, other.v_);
-    return *this;
-};
-
-const double& Vector3::operator[](const int &index) const {
-    switch (index) {
-        case 0:
-            return x();
-        case 1:
-            return y();
-        case 2:
-            return z();
-        default:
-            throw std::out_of_range("index out of range, Vector3 only have three elements");
-    }
-}
-
-double& Vector3::operator[](const int &index) {
-    switch (index) {
-        case 0:
-            return v_->x_;
-        case 1:
-            return v_->y_;
-        case 2:
-            return v_->z_;
-        default:
-            throw std::out_of_range("index out of range, Vector3 only have three elements");
-    }
-}
-
-bool Vector3::operator==(const std::initializer_list<double>& vector) const {
+template <class T>
+bool Vector3T<T>::operator==(const std::initializer_list<T>& vector) const {
     if (vector.size() != 3) {
         return false;
     }
     auto it = vector.begin();
-    if (!almost_equal(x(), *it, resolution)) {
+    if (!almost_equal(x(), *it, ScalarTraits<T>::kResolution)) {
         return false;
     }
     ++it;
-    if (!almost_equal(y(), *it, resolution)) {
+    if (!almost_equal(y(), *it, ScalarTraits<T>::kResolution)) {
         return false;
     }
     ++it;
-    if (!almost_equal(z(), *it, resolution)) {
+    if (!almost_equal(z(), *it, ScalarTraits<T>::kResolution)) {
         return false;
     }
     return true;
 }
 
-bool Vector3::operator==(const Vector3& vector) const {
-    return (Vector3(v_->x_, v_->y_, v_->z_) == std::initializer_list<double>({vector.v_->x_, vector.v_->y_, vector.v_->z_}));
+template <class T>
+bool Vector3T<T>::operator==(const Vector3T<T>& vector) const {
+    return (*this == std::initializer_list<T>({vector.x(), vector.y(), vector.z()}));
 }
 
-bool ekumen::math::Vector3::operator != (const Vector3& vector) const {
+template <class T>
+bool Vector3T<T>::operator != (const Vector3T<T>& vector) const {
     return !(*this == vector);
 }
 
-bool ekumen::math::Vector3::operator != (const std::initializer_list<double>& list) const {
+template <class T>
+bool Vector3T<T>::operator != (const std::initializer_list<T>& list) const {
     return !(*this == list);
 }
 
-double Vector3::norm() const {
-    return std::sqrt(dot(*this));
-};
-
-double Vector3::dot(const Vector3& vector) const {
-    return ((x() * vector.x()) + (y() * vector.y()) + (z() * vector.z()));
-};
-
-Vector3 Vector3::cross(const Vector3& vector) const {
-    auto i = (y() * vector.z()) - (vector.y() * z());
-    auto j = (x() * vector.z()) - (vector.x() * z());
-    auto k = (x() * vector.y()) - (vector.x() * y());
-
-    return Vector3(i, j, k);
-}
-
-Matrix3::Matrix3(const std::initializer_list<double>& values) {
-    if(values.size() != 9) {
-        throw "Invalid initializer list size";
-    }
-    std::initializer_list<double>::iterator it = values.begin();
-    Vector3 r1, r2, r3;
-    r1[0] = *it++;
-    r1[1] = *it++;
-    r1[2] = *it++;
-
-    r2[0] = *it++;
-    r2[1] = *it++;
-    r2[2] = *it++;
-
-    r3[0] = *it++;
-    r3[1] = *it++;
-    r3[2] = *it++;
-    m_ = new Rows{r1, r2, r3};
-}
-
-const Vector3& Matrix3::row(uint32_t index) const {
-    if(index > 2) {
-        throw std::out_of_range("index out of range, Matrix3 only have three rows");
-    }
-    return (*this)[index];
-}
-
-const Vector3 Matrix3::col(uint32_t index) const {
-    if(index > 2) {
-        throw std::out_of_range("index out of range, Matrix3 only have three rows");
-    }
-    return Vector3(r1()[index], r2()[index], r3()[index]);
-}
-
-Vector3& Matrix3::operator[](const uint32_t index) {
-    switch(index) {
-        case 0:
-            return r1();
-        case 1:
-            return r2();
-        case 2:
-            return r3();
-        default:
-            throw std::out_of_range("Error. Invalid row index for Matrix3");
-    }
-}
-
-const Vector3& Matrix3::operator[](const uint32_t index) const {
-    switch(index) {
-        case 0:
-            return r1();
-        case 1:
-            return r2();
-        case 2:
-            return r3();
-        default:
-            throw std::out_of_range("Error. Invalid row index for Matrix3");
-    }
-}
-
-Matrix3 Matrix3::operator+(const Matrix3& matrix) const {
-    Matrix3 aux(*this);
-    aux += matrix;
-    return aux;
-}
-
-Matrix3 Matrix3::operator-(const Matrix3& matrix) const {
-    Matrix3 aux(*this);
-    aux -= matrix;
-    return aux;
-}
-
-Matrix3 Matrix3::operator*(const double& value) const {
-    Matrix3 aux(*this);
-    aux *= value;
-    return aux;
-}
-
-Matrix3 Matrix3::operator*(const Matrix3& matrix) const {
-    Matrix3 aux(*this);
-    aux *= matrix;
-    return aux;
-}
-
-Matrix3 Matrix3::operator/(const Matrix3& matrix) const {
-    Matrix3 aux(*this);
-    aux /= matrix;
-    return aux;
-}
-
-Vector3 Matrix3::operator*(const Vector3& vector) const {
-    Vector3 result;
-    result.x() = r1().x() * vector.x() + r1().y() * vector.y() + r1().z() * vector.z();
-    result.y() = r2().x() * vector.x() + r2().y() * vector.y() + r2().z() * vector.z();
-    result.z() = r3().x() * vector.x() + r3().y() * vector.y() + r3().z() * vector.z();
-    return result;
-}
-
-Matrix3 Matrix3::operator/(const double& value) const {
-    Matrix3 aux(*this);
-    aux.r1() /= value;
-    aux.r2() /= value;
-    aux.r2() /= value;
-    return aux;
-}
-
-Matrix3& Matrix3::operator+=(const Matrix3& matrix) {
-    r1() += matrix.r1();
-    r2() += matrix.r2();
-    r3() += matrix.r3();
-    return *this;
-}
-
-Matrix3& Matrix3::operator-=(const Matrix3& matrix) {
-    r1() -= matrix.r1();
-    r2() -= matrix.r2();
-    r3() -= matrix.r3();
-    return *this;
-}
-
-Matrix3& Matrix3::operator*=(const double& value) {
-    r1() *= value;
-    r2() *= value;
-    r3() *= value;
-    return *this;
-}
-
-Matrix3& Matrix3::operator*=(const Matrix3& matrix) {
-    r1() *= matrix.r1();
-    r2() *= matrix.r2();
-    r3() *= matrix.r3();
-    return *this;
-}
-
-Matrix3& Matrix3::operator/=(const Matrix3& matrix) {
-    r1() /= matrix.r1();
-    r2() /= matrix.r2();
-    r3() /= matrix.r3();
-    return *this;
-}
-
-bool Matrix3::operator==(const Matrix3& matrix) const {
+template <class T>
+bool Matrix3T<T>::operator==(const Matrix3T<T>& matrix) const {
     if ((r1() == matrix.r1()) && (r2() == matrix.r2()) && (r3() == matrix.r3())) {
         return true;
     }
     return false;
 }
 
-bool Matrix3::operator!=(const Matrix3& matrix) const {
+template <class T>
+bool Matrix3T<T>::operator!=(const Matrix3T<T>& matrix) const {
     return !(*this == matrix);
 }
 
-Matrix3& Matrix3::operator=(const Matrix3& matrix){
-    r1() = matrix.r1();
-    r2() = matrix.r2();
-    r3() = matrix.r3();
-    return *this;
-}
-
-Matrix3& Matrix3::operator=(Matrix3&& matrix) {
-    r1() = std::move(matrix.r1());
-    r2() = std::move(matrix.r2());
-    r3() = std::move(matrix.r3());
-    return *this;
-}
-
-Matrix3 Matrix3::inverse() const {
-    if (almost_equal(det(), 0., 4)) {
-        throw std::domain_error("It can not get the inverse of the matrix");
-    }
-    Matrix3 aux;
+template <class T>
+Matrix3T<T> Matrix3T<T>::adjugate() const {
+    Matrix3T<T> aux;
     aux.r1().x() = r2().y() * r3().z() - r2().z() * r3().y();
-    aux.r1().y() = r1().z() * r3().z() - r1().y() * r3().z();
+    aux.r1().y() = r1().z() * r3().y() - r1().y() * r3().z();
     aux.r1().z() = r1().y() * r2().z() - r2().y() * r1().z();
     aux.r2().x() = r2().z() * r3().x() - r2().x() * r3().z();
     aux.r2().y() = r1().x() * r3().z() - r1().z() * r3().x();
@@ -341,58 +69,80 @@ Matrix3 Matrix3::inverse() const {
     aux.r3().x() = r2().x() * r3().y() - r2().y() * r3().x();
     aux.r3().y() = r1().y() * r3().x() - r1().x() * r3().y();
     aux.r3().z() = r1().x() * r2().y() - r1().y() * r2().x();
-    return aux/((*this).det());
-}
-
-double Matrix3::det() const {
-    double subdet1 = r2()[1] * r3()[2] - r2()[2] * r3()[1];
-    double subdet2 = r2()[0] * r3()[2] - r2()[2] * r3()[0];
-    double subdet3 = r2()[0] * r3()[1] - r2()[1] * r3()[0];
-    return r1()[0] * subdet1 - r1()[1] * subdet2 + r1()[2] * subdet3;
-}
-
-const Matrix3 Matrix3::kIdentity = 
-    Matrix3(Vector3(1, 0, 0), Vector3(0, 1, 0), Vector3(0, 0, 1));
-
-const Matrix3 Matrix3::kZero = 
-    Matrix3(Vector3(0, 0, 0), Vector3(0, 0, 0), Vector3(0, 0, 0));
-
-const Matrix3 Matrix3::kOnes = 
-    Matrix3(Vector3(1, 1, 1), Vector3(1, 1, 1), Vector3(1, 1, 1));
-
-// Isometry
-Isometry::Isometry(const Matrix3& rotation) {
-    rotation_ = rotation;
-    translation_ = Vector3(0.0, 0.0, 0.0);
+    return aux;
 }
 
-Isometry::Isometry(const Vector3& translation, const Matrix3& rotation) {
-    rotation_ = rotation;
-    translation_ = translation;
+template <class T>
+Matrix3T<T> Matrix3T<T>::inverse() const {
+    const T determinant = det();
+    if (almost_equal(determinant, T(0), ScalarTraits<T>::kResolution)) {
+        throw std::domain_error("It can not get the inverse of the matrix");
+    }
+    return adjugate() / determinant;
 }
 
-Isometry Isometry::compose(const Isometry& isometry) const {
-    Isometry aux(*this);
-    return Isometry(*this) = aux * isometry;
-};
-
-Isometry Isometry::inverse() const {
-    auto vector_result = (rotation_.inverse() * translation_) * -1;
-    return Isometry{vector_result, rotation_.inverse()};
+// Largest column sum of absolute values.
+template <class T>
+T OneNorm(const Matrix3T<T>& matrix) {
+    T norm{0};
+    for (int column = 0; column < 3; ++column) {
+        norm = std::max(norm, std::fabs(matrix.r1()[column]) + std::fabs(matrix.r2()[column]) +
+                                  std::fabs(matrix.r3()[column]));
+    }
+    return norm;
 }
 
-Isometry Isometry::FromTranslation(const Vector3& vector) {
-    return Isometry(vector, Matrix3::kIdentity);
+template <class T>
+InverseResultT<T> Matrix3T<T>::tryInverse() const noexcept {
+    const T determinant = det();
+    if (almost_equal(determinant, T(0), ScalarTraits<T>::kResolution)) {
+        return InverseResultT<T>{InverseStatus::kSingular, kZero, std::numeric_limits<T>::infinity()};
+    }
+    const Matrix3T<T> inverse = adjugate() / determinant;
+    return InverseResultT<T>{InverseStatus::kOk, inverse, OneNorm(*this) * OneNorm(inverse)};
 }
 
-Isometry Isometry::FromEulerAngles(const double yaw, const double pitch, const double roll) {
-    Isometry result = Isometry(RotateAround(Vector3::kUnitX, yaw)) * Isometry(RotateAround(Vector3::kUnitY, pitch)) *
-            Isometry(RotateAround(Vector3::kUnitZ, roll));
+// Isometry
+template <class T>
+void IsometryT<T>::transform(const Vector3T<T>* points, Vector3T<T>* out, size_t count) const {
+    const Vector3T<T>& r1 = rotation_.r1();
+    const Vector3T<T>& r2 = rotation_.r2();
+    const Vector3T<T>& r3 = rotation_.r3();
+    for (size_t i = 0; i < count; ++i) {
+        const T x = points[i].x();
+        const T y = points[i].y();
+        const T z = points[i].z();
+        out[i].x() = r1.x() * x + r1.y() * y + r1.z() * z + translation_.x();
+        out[i].y() = r2.x() * x + r2.y() * y + r2.z() * z + translation_.y();
+        out[i].z() = r3.x() * x + r3.y() * y + r3.z() * z + translation_.z();
+    }
+}
+
+template <class T>
+void IsometryT<T>::transform(const T* x, const T* y, const T* z, T* out_x, T* out_y, T* out_z,
+                             size_t count) const {
+    const T rotation[9]{rotation_[0][0], rotation_[0][1], rotation_[0][2],
+                        rotation_[1][0], rotation_[1][1], rotation_[1][2],
+                        rotation_[2][0], rotation_[2][1], rotation_[2][2]};
+    const T translation[3]{translation_.x(), translation_.y(), translation_.z()};
+    TransformSoA(rotation, translation, x, y, z, out_x, out_y, out_z, count);
+}
+
+template <class T>
+void IsometryT<T>::normalize() {
+    rotation_ = NearestRotation(rotation_);
+}
+
+template <class T>
+IsometryT<T> IsometryT<T>::FromEulerAngles(const T yaw, const T pitch, const T roll) {
+    IsometryT<T> result = IsometryT<T>(RotateAround(Vector3T<T>::kUnitX, yaw)) *
+            IsometryT<T>(RotateAround(Vector3T<T>::kUnitY, pitch)) * IsometryT<T>(RotateAround(Vector3T<T>::kUnitZ, roll));
     return result;
 }
 
-Isometry Isometry::RotateAround(const Vector3& axis, const double angle) {
-    Matrix3 result;
+template <class T>
+IsometryT<T> IsometryT<T>::RotateAround(const Vector3T<T>& axis, const T angle) {
+    Matrix3T<T> result;
     auto cos = std::cos(angle);
     auto sin = std::sin(angle);
     result.r1().x() = cos + (axis.x() * axis.x()) * (1 - cos);
@@ -403,14 +153,15 @@ Isometry Isometry::RotateAround(const Vector3& axis, const double angle) {
     result.r2().y() = cos + (axis.y() * axis.y()) * (1 - cos);
     result.r2().z() = axis.y() * axis.z() * (1 - cos) - axis.x() * sin;
 
-    result.r3().x() = axis.z() * axis.x() * (1 - cos) + axis.y() * sin;
+    result.r3().x() = axis.z() * axis.x() * (1 - cos) - axis.y() * sin;
     result.r3().y() = axis.z() * axis.y() * (1 - cos) + axis.x() * sin;
     result.r3().z() = cos + (axis.z() * axis.z()) * (1 - cos);
-    return Isometry(Vector3(), result);
+    return IsometryT<T>(Vector3T<T>(), result);
 }
 
-// // Operators
-bool Isometry::operator==(const Isometry& isometry) const {
+// Operators
+template <class T>
+bool IsometryT<T>::operator==(const IsometryT<T>& isometry) const {
     if (rotation_ != isometry.rotation_) {
         return false;
     }
@@ -420,13 +171,13 @@ bool Isometry::operator==(const Isometry& isometry) const {
     return true;
 }
 
-Vector3 Isometry::operator*(const Vector3& vector) const{
-    return (rotation_ * vector + translation_);
-}
-
-Isometry Isometry::operator*(const Isometry& isometry) const {
-    return Isometry((rotation_ * isometry.translation()) + translation_, rotation_ * isometry.rotation());
-}
+// Supported scalar types.
+template class Vector3T<double>;
+template class Vector3T<float>;
+template class Matrix3T<double>;
+template class Matrix3T<float>;
+template class IsometryT<double>;
+template class IsometryT<float>;
 
 }
 }
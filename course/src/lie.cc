@@ -0,0 +1,184 @@
+#include "lie.h"
+
+#include <cmath>
+
+namespace ekumen {
+namespace math {
+namespace {
+
+// Squared angle below which the coefficients come from their Taylor expansions. With four
+// terms the first one dropped is below epsilon there.
+template <class T>
+struct LieTraits;
+
+template <>
+struct LieTraits<double> {
+    static constexpr double kTaylorThreshold{1e-4};
+};
+
+template <>
+struct LieTraits<float> {
+    static constexpr float kTaylorThreshold{0.05f};
+};
+
+// Coefficients of the Rodrigues formulas for a squared angle |t| = theta^2:
+// exp(W) = I + a W + b W^2 and V = I + b W + c W^2, with W the cross product matrix of the
+// rotation vector. The closed forms of b and c lose digits to cancellation as theta shrinks,
+// but they multiply terms that shrink with theta^2 as well, so the absolute error stays at
+// epsilon.
+template <class T>
+struct RodriguesCoefficients {
+    T a, b, c;
+};
+
+template <class T>
+__attribute__((always_inline)) inline RodriguesCoefficients<T> Rodrigues(const T t) {
+    if (t < LieTraits<T>::kTaylorThreshold) {
+        return RodriguesCoefficients<T>{T(1) - t / 6 * (T(1) - t / 20 * (T(1) - t / 42)),
+                                        T(0.5) - t / 24 * (T(1) - t / 30 * (T(1) - t / 56)),
+                                        T(1) / 6 - t / 120 * (T(1) - t / 42 * (T(1) - t / 72))};
+    }
+    const T theta = std::sqrt(t);
+    const T sin = std::sin(theta);
+    const T half_sin = std::sin(theta / 2);
+    return RodriguesCoefficients<T>{sin / theta, 2 * half_sin * half_sin / t, (theta - sin) / (theta * t)};
+}
+
+template <class T>
+__attribute__((always_inline)) inline Matrix3T<T> RotationFromCoefficients(const Vector3T<T>& w, const T t,
+                                                                           const T a, const T b) {
+    // I + a W + b (w w^T - t I).
+    const T diagonal = 1 - b * t;
+    return Matrix3T<T>(
+        Vector3T<T>(diagonal + b * w.x() * w.x(), b * w.x() * w.y() - a * w.z(), b * w.x() * w.z() + a * w.y()),
+        Vector3T<T>(b * w.y() * w.x() + a * w.z(), diagonal + b * w.y() * w.y(), b * w.y() * w.z() - a * w.x()),
+        Vector3T<T>(b * w.z() * w.x() - a * w.y(), b * w.z() * w.y() + a * w.x(), diagonal + b * w.z() * w.z()));
+}
+
+template <class T>
+__attribute__((always_inline)) inline Vector3T<T> Log(const Matrix3T<T>& r) {
+    const T cos = (r[0][0] + r[1][1] + r[2][2] - 1) / 2;
+    // sin(theta) times the axis.
+    const Vector3T<T> w = Vector3T<T>(r[2][1] - r[1][2], r[0][2] - r[2][0], r[1][0] - r[0][1]) * T(0.5);
+    const T sin = w.norm();
+    const T theta = std::atan2(sin, cos);
+    if (cos > 0 || sin > T(0.5)) {
+        const T t = theta * theta;
+        // theta / sin(theta).
+        const T scale = t < LieTraits<T>::kTaylorThreshold
+                            ? T(1) + t / 6 * (T(1) + t * 7 / 60 * (T(1) + t * 31 / 294))
+                            : theta / sin;
+        return w * scale;
+    }
+    // Past 150 degrees w fades with sin(theta), while the symmetric part
+    // (R + R^T) / 2 - cos I = (1 - cos) n n^T keeps the axis n. Reads it off the row of the
+    // largest diagonal element, and takes the sign from w.
+    const T one_minus_cos = 1 - cos;
+    int i = 0;
+    for (int k = 1; k < 3; ++k) {
+        if (r[k][k] > r[i][i]) {
+            i = k;
+        }
+    }
+    const T ni = std::sqrt(std::fmax(r[i][i] - cos, T(0)) / one_minus_cos);
+    Vector3T<T> axis;
+    for (int k = 0; k < 3; ++k) {
+        axis[k] = k == i ? ni : (r[i][k] + r[k][i]) / (2 * one_minus_cos * ni);
+    }
+    if (axis.dot(w) < 0) {
+        axis = axis * T(-1);
+    }
+    return axis * theta;
+}
+
+template <class T>
+__attribute__((always_inline)) inline IsometryT<T> Exp(const TwistT<T>& twist) {
+    const Vector3T<T>& w = twist.angular;
+    const T t = w.dot(w);
+    const RodriguesCoefficients<T> k = Rodrigues(t);
+    const Vector3T<T> wv = w.cross(twist.linear);
+    const Vector3T<T> translation = twist.linear + wv * k.b + w.cross(wv) * k.c;
+    return IsometryT<T>(translation, RotationFromCoefficients(w, t, k.a, k.b));
+}
+
+template <class T>
+__attribute__((always_inline)) inline TwistT<T> Log(const IsometryT<T>& isometry) {
+    const Vector3T<T> w = Log(isometry.rotation());
+    const T t = w.dot(w);
+    // V^-1 = I - W / 2 + d W^2, with d = (1 - a / (2 b)) / theta^2.
+    T d;
+    if (t < LieTraits<T>::kTaylorThreshold) {
+        d = T(1) / 12 + t / 720 * (T(1) + t / 42 * (T(1) + t / 40));
+    } else {
+        const RodriguesCoefficients<T> k = Rodrigues(t);
+        d = (1 - k.a / (2 * k.b)) / t;
+    }
+    const Vector3T<T>& u = isometry.translation();
+    const Vector3T<T> wu = w.cross(u);
+    return TwistT<T>{u - wu * T(0.5) + w.cross(wu) * d, w};
+}
+
+}  // namespace
+
+template <class T>
+Matrix3T<T> ExpSO3(const Vector3T<T>& rotation_vector) {
+    const T t = rotation_vector.dot(rotation_vector);
+    const RodriguesCoefficients<T> k = Rodrigues(t);
+    return RotationFromCoefficients(rotation_vector, t, k.a, k.b);
+}
+
+template <class T>
+Vector3T<T> LogSO3(const Matrix3T<T>& rotation) {
+    return Log(rotation);
+}
+
+template <class T>
+IsometryT<T> ExpSE3(const TwistT<T>& twist) {
+    return Exp(twist);
+}
+
+template <class T>
+TwistT<T> LogSE3(const IsometryT<T>& isometry) {
+    return Log(isometry);
+}
+
+template <class T>
+void ExpSE3Batch(const TwistT<T>* twists, IsometryT<T>* out, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = Exp(twists[i]);
+    }
+}
+
+template <class T>
+void LogSE3Batch(const IsometryT<T>* isometries, TwistT<T>* out, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = Log(isometries[i]);
+    }
+}
+
+template <class T>
+IsometryT<T> Interpolate(const IsometryT<T>& from, const IsometryT<T>& to, const T t) {
+    const TwistT<T> delta = Log(from.inverse() * to);
+    return from * Exp(TwistT<T>{delta.linear * t, delta.angular * t});
+}
+
+// Supported scalar types.
+template Matrix3T<double> ExpSO3<double>(const Vector3T<double>& rotation_vector);
+template Matrix3T<float> ExpSO3<float>(const Vector3T<float>& rotation_vector);
+template Vector3T<double> LogSO3<double>(const Matrix3T<double>& rotation);
+template Vector3T<float> LogSO3<float>(const Matrix3T<float>& rotation);
+template IsometryT<double> ExpSE3<double>(const TwistT<double>& twist);
+template IsometryT<float> ExpSE3<float>(const TwistT<float>& twist);
+template TwistT<double> LogSE3<double>(const IsometryT<double>& isometry);
+template TwistT<float> LogSE3<float>(const IsometryT<float>& isometry);
+template void ExpSE3Batch<double>(const TwistT<double>* twists, IsometryT<double>* out, size_t count);
+template void ExpSE3Batch<float>(const TwistT<float>* twists, IsometryT<float>* out, size_t count);
+template void LogSE3Batch<double>(const IsometryT<double>* isometries, TwistT<double>* out, size_t count);
+template void LogSE3Batch<float>(const IsometryT<float>* isometries, TwistT<float>* out, size_t count);
+template IsometryT<double> Interpolate<double>(const IsometryT<double>& from, const IsometryT<double>& to,
+                                               const double t);
+template IsometryT<float> Interpolate<float>(const IsometryT<float>& from, const IsometryT<float>& to,
+                                             const float t);
+
+}  // namespace math
+}  // namespace ekumen
@@ -0,0 +1,71 @@
+#include "point_cloud.h"
+
+namespace ekumen {
+namespace math {
+
+template <class T>
+void PointCloudT<T>::reserve(size_t size) {
+    x_.reserve(size);
+    y_.reserve(size);
+    z_.reserve(size);
+    if (intensity_enabled_) {
+        intensity_.reserve(size);
+    }
+    if (timestamp_enabled_) {
+        timestamp_.reserve(size);
+    }
+}
+
+template <class T>
+void PointCloudT<T>::resize(size_t size) {
+    x_.resize(size, T(0));
+    y_.resize(size, T(0));
+    z_.resize(size, T(0));
+    if (intensity_enabled_) {
+        intensity_.resize(size, 0.f);
+    }
+    if (timestamp_enabled_) {
+        timestamp_.resize(size, 0.);
+    }
+}
+
+template <class T>
+void PointCloudT<T>::push_back(const Vector3T<T>& point) {
+    x_.push_back(point.x());
+    y_.push_back(point.y());
+    z_.push_back(point.z());
+    if (intensity_enabled_) {
+        intensity_.push_back(0.f);
+    }
+    if (timestamp_enabled_) {
+        timestamp_.push_back(0.);
+    }
+}
+
+template <class T>
+void PointCloudT<T>::transform(const IsometryT<T>& isometry) {
+    isometry.transform(x_.data(), y_.data(), z_.data(), x_.data(), y_.data(), z_.data(), size());
+}
+
+template <class T>
+PointCloudT<T> PointCloudT<T>::transformed(const IsometryT<T>& isometry) const {
+    PointCloudT<T> result;
+    result.x_.resize(size());
+    result.y_.resize(size());
+    result.z_.resize(size());
+    result.intensity_ = intensity_;
+    result.timestamp_ = timestamp_;
+    result.intensity_enabled_ = intensity_enabled_;
+    result.timestamp_enabled_ = timestamp_enabled_;
+    // Writes straight into the new arrays rather than copying the points first.
+    isometry.transform(x_.data(), y_.data(), z_.data(), result.x_.data(), result.y_.data(), result.z_.data(),
+                       size());
+    return result;
+}
+
+// Supported scalar types.
+template class PointCloudT<double>;
+template class PointCloudT<float>;
+
+}  // namespace math
+}  // namespace ekumen
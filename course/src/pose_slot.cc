@@ -0,0 +1,100 @@
+#include "pose_slot.h"
+
+#include <cstring>
+#include <thread>
+
+namespace ekumen {
+namespace math {
+namespace {
+
+constexpr int kSpinsBeforeYield{64};
+
+// Words hold the bit patterns of the doubles, so a pose round-trips exactly.
+uint64_t ToWord(const double value) {
+    uint64_t word;
+    std::memcpy(&word, &value, sizeof(word));
+    return word;
+}
+
+double FromWord(const uint64_t word) {
+    double value;
+    std::memcpy(&value, &word, sizeof(value));
+    return value;
+}
+
+void ToValues(const Isometry& pose, double values[12]) {
+    const Matrix3& rotation = pose.rotation();
+    for (uint32_t row = 0; row < 3; ++row) {
+        for (int column = 0; column < 3; ++column) {
+            values[3 * row + column] = rotation[row][column];
+        }
+        values[9 + row] = pose.translation()[row];
+    }
+}
+
+}  // namespace
+
+constexpr size_t PoseSlot::kWords;
+
+PoseSlot::PoseSlot() : PoseSlot(Isometry::FromTranslation(Vector3::kZero)) {}
+
+PoseSlot::PoseSlot(const Isometry& pose) {
+    // The initial pose does not count as a publication, and no reader can run yet.
+    double values[kWords];
+    ToValues(pose, values);
+    for (size_t i = 0; i < kWords; ++i) {
+        words_[i].store(ToWord(values[i]), std::memory_order_relaxed);
+    }
+}
+
+void PoseSlot::publish(const Isometry& pose) {
+    double values[kWords];
+    ToValues(pose, values);
+    // Claim the slot by making the counter odd. Only other writers ever wait here.
+    uint64_t sequence = sequence_.load(std::memory_order_relaxed);
+    do {
+        sequence &= ~uint64_t{1};
+    } while (!sequence_.compare_exchange_weak(sequence, sequence + 1, std::memory_order_acquire,
+                                              std::memory_order_relaxed));
+    // Orders the odd counter before the stores below, so a reader that sees any new word also
+    // sees the counter change.
+    std::atomic_thread_fence(std::memory_order_release);
+    for (size_t i = 0; i < kWords; ++i) {
+        words_[i].store(ToWord(values[i]), std::memory_order_relaxed);
+    }
+    sequence_.store(sequence + 2, std::memory_order_release);
+}
+
+Isometry PoseSlot::read() const {
+    return read(nullptr);
+}
+
+Isometry PoseSlot::read(uint64_t* version) const {
+    double values[kWords];
+    uint64_t before;
+    uint64_t after;
+    int attempts{0};
+    do {
+        // A writer descheduled in the middle of a publish keeps readers retrying, so give it the
+        // core back instead of spinning through a whole time slice.
+        if (++attempts % kSpinsBeforeYield == 0) {
+            std::this_thread::yield();
+        }
+        before = sequence_.load(std::memory_order_acquire);
+        for (size_t i = 0; i < kWords; ++i) {
+            values[i] = FromWord(words_[i].load(std::memory_order_relaxed));
+        }
+        // Orders the word loads before the second counter load.
+        std::atomic_thread_fence(std::memory_order_acquire);
+        after = sequence_.load(std::memory_order_relaxed);
+    } while ((before & 1) != 0 || before != after);
+    if (version != nullptr) {
+        *version = before / 2;
+    }
+    return Isometry(Vector3(values[9], values[10], values[11]),
+                    Matrix3(Vector3(values[0], values[1], values[2]), Vector3(values[3], values[4], values[5]),
+                            Vector3(values[6], values[7], values[8])));
+}
+
+}  // namespace math
+}  // namespace ekumen
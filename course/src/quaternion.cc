@@ -0,0 +1,129 @@
+#include <cmath>
+#include "quaternion.h"
+
+namespace ekumen {
+namespace math {
+
+Quaternion Quaternion::operator*(const Quaternion& q) const {
+    return Quaternion(w_ * q.w_ - x_ * q.x_ - y_ * q.y_ - z_ * q.z_,
+                      w_ * q.x_ + x_ * q.w_ + y_ * q.z_ - z_ * q.y_,
+                      w_ * q.y_ - x_ * q.z_ + y_ * q.w_ + z_ * q.x_,
+                      w_ * q.z_ + x_ * q.y_ - y_ * q.x_ + z_ * q.w_);
+}
+
+bool Quaternion::operator==(const Quaternion& quaternion) const {
+    return almost_equal(w_, quaternion.w_, resolution) && almost_equal(x_, quaternion.x_, resolution) &&
+           almost_equal(y_, quaternion.y_, resolution) && almost_equal(z_, quaternion.z_, resolution);
+}
+
+bool Quaternion::operator!=(const Quaternion& quaternion) const {
+    return !(*this == quaternion);
+}
+
+double Quaternion::dot(const Quaternion& quaternion) const {
+    return w_ * quaternion.w_ + x_ * quaternion.x_ + y_ * quaternion.y_ + z_ * quaternion.z_;
+}
+
+double Quaternion::norm() const {
+    return std::sqrt(dot(*this));
+}
+
+Quaternion Quaternion::conjugate() const {
+    return Quaternion(w_, -x_, -y_, -z_);
+}
+
+Quaternion Quaternion::normalized() const {
+    Quaternion aux(*this);
+    aux.normalize();
+    return aux;
+}
+
+void Quaternion::normalize() {
+    const double scale = 1. / norm();
+    w_ *= scale;
+    x_ *= scale;
+    y_ *= scale;
+    z_ *= scale;
+}
+
+Vector3 Quaternion::rotate(const Vector3& vector) const {
+    // v' = v + 2w (u x v) + 2u x (u x v), with u the vector part.
+    const Vector3 u(x_, y_, z_);
+    const Vector3 t = u.cross(vector) * 2.;
+    return vector + t * w_ + u.cross(t);
+}
+
+Matrix3 Quaternion::toMatrix() const {
+    const double xx = x_ * x_, yy = y_ * y_, zz = z_ * z_;
+    const double xy = x_ * y_, xz = x_ * z_, yz = y_ * z_;
+    const double wx = w_ * x_, wy = w_ * y_, wz = w_ * z_;
+    return Matrix3{1. - 2. * (yy + zz), 2. * (xy - wz), 2. * (xz + wy),
+                   2. * (xy + wz), 1. - 2. * (xx + zz), 2. * (yz - wx),
+                   2. * (xz - wy), 2. * (yz + wx), 1. - 2. * (xx + yy)};
+}
+
+Quaternion Quaternion::FromAxisAngle(const Vector3& axis, const double angle) {
+    const Vector3 unit = axis / axis.norm();
+    const double sin = std::sin(angle / 2.);
+    return Quaternion(std::cos(angle / 2.), unit.x() * sin, unit.y() * sin, unit.z() * sin);
+}
+
+Quaternion Quaternion::FromMatrix(const Matrix3& m) {
+    // Shepperd's method: pivot on the largest of w, x, y, z to stay well conditioned.
+    const double trace = m[0][0] + m[1][1] + m[2][2];
+    Quaternion result;
+    if (trace > m[0][0] && trace > m[1][1] && trace > m[2][2]) {
+        const double s = 2. * std::sqrt(1. + trace);
+        result = Quaternion(s / 4., (m[2][1] - m[1][2]) / s, (m[0][2] - m[2][0]) / s, (m[1][0] - m[0][1]) / s);
+    } else if (m[0][0] > m[1][1] && m[0][0] > m[2][2]) {
+        const double s = 2. * std::sqrt(1. + m[0][0] - m[1][1] - m[2][2]);
+        result = Quaternion((m[2][1] - m[1][2]) / s, s / 4., (m[0][1] + m[1][0]) / s, (m[0][2] + m[2][0]) / s);
+    } else if (m[1][1] > m[2][2]) {
+        const double s = 2. * std::sqrt(1. + m[1][1] - m[0][0] - m[2][2]);
+        result = Quaternion((m[0][2] - m[2][0]) / s, (m[0][1] + m[1][0]) / s, s / 4., (m[1][2] + m[2][1]) / s);
+    } else {
+        const double s = 2. * std::sqrt(1. + m[2][2] - m[0][0] - m[1][1]);
+        result = Quaternion((m[1][0] - m[0][1]) / s, (m[0][2] + m[2][0]) / s, (m[1][2] + m[2][1]) / s, s / 4.);
+    }
+    // q and -q are the same rotation, keep w non negative.
+    if (result.w() < 0.) {
+        result = Quaternion(-result.w(), -result.x(), -result.y(), -result.z());
+    }
+    return result;
+}
+
+Quaternion Quaternion::Slerp(const Quaternion& from, const Quaternion& to, const double t) {
+    // Below this angle the normalized lerp is exact to double precision.
+    constexpr double kLerpThreshold{1e-8};
+    const double sign = from.dot(to) < 0. ? -1. : 1.;
+    const Quaternion target(sign * to.w_, sign * to.x_, sign * to.y_, sign * to.z_);
+    // Angle between the 4D vectors. atan2 keeps it accurate for nearby inputs, where acos of
+    // the dot product would not.
+    const Quaternion difference(from.w_ - target.w_, from.x_ - target.x_, from.y_ - target.y_, from.z_ - target.z_);
+    const Quaternion sum(from.w_ + target.w_, from.x_ + target.x_, from.y_ + target.y_, from.z_ + target.z_);
+    const double theta = 2. * std::atan2(difference.norm(), sum.norm());
+    double from_weight = 1. - t;
+    double to_weight = t;
+    if (theta > kLerpThreshold) {
+        const double inverse_sin = 1. / std::sin(theta);
+        from_weight = std::sin((1. - t) * theta) * inverse_sin;
+        to_weight = std::sin(t * theta) * inverse_sin;
+    }
+    Quaternion result(from_weight * from.w_ + to_weight * target.w_, from_weight * from.x_ + to_weight * target.x_,
+                      from_weight * from.y_ + to_weight * target.y_, from_weight * from.z_ + to_weight * target.z_);
+    result.normalize();
+    return result;
+}
+
+// QuaternionIsometry
+QuaternionIsometry QuaternionIsometry::inverse() const {
+    const Quaternion rotation = rotation_.conjugate();
+    return QuaternionIsometry(rotation.rotate(translation_) * -1., rotation);
+}
+
+QuaternionIsometry QuaternionIsometry::operator*(const QuaternionIsometry& isometry) const {
+    return QuaternionIsometry(rotation_.rotate(isometry.translation_) + translation_, rotation_ * isometry.rotation_);
+}
+
+}  // namespace math
+}  // namespace ekumen
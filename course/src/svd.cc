@@ -0,0 +1,273 @@
+#include "svd.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+
+#include "symmetric_eigen.h"
+
+namespace ekumen {
+namespace math {
+namespace {
+
+// Matrices decomposed per EigenDecomposeBatch() call in ComputeSvdBatch(), sized to stay on
+// the stack.
+constexpr size_t kBatchChunk{64};
+
+// Matrices per lockstep group, as in symmetric_eigen.cc.
+template <class T>
+constexpr size_t kGroupSize{32 / sizeof(T)};
+
+// Exponent e such that the largest element of |matrix| divided by 2^e lies in [0.5, 1), or 0
+// if the fourth powers of the elements, which the rotation angles square the Gram matrix into,
+// are safely inside the range of T as it is. They would otherwise overflow, or lose precision
+// to subnormals.
+template <class T>
+int ScaleExponent(const Matrix3T<T>& matrix) {
+    constexpr int kSafeExponent{std::numeric_limits<T>::max_exponent / 8};
+    T largest = 0;
+    for (uint32_t row = 0; row < 3; ++row) {
+        for (uint32_t column = 0; column < 3; ++column) {
+            largest = std::max(largest, std::fabs(matrix[row][column]));
+        }
+    }
+    if (largest == 0 || !std::isfinite(largest)) {
+        return 0;
+    }
+    int exponent;
+    std::frexp(largest, &exponent);
+    return std::abs(exponent) <= kSafeExponent ? 0 : exponent;
+}
+
+// |matrix| * 2^exponent, exact unless elements far below the largest go subnormal.
+template <class T>
+Matrix3T<T> Ldexp(const Matrix3T<T>& matrix, const int exponent) {
+    Matrix3T<T> result;
+    for (uint32_t row = 0; row < 3; ++row) {
+        for (uint32_t column = 0; column < 3; ++column) {
+            result[row][column] = std::ldexp(matrix[row][column], exponent);
+        }
+    }
+    return result;
+}
+
+template <class T>
+Vector3T<T> Ldexp(const Vector3T<T>& vector, const int exponent) {
+    return Vector3T<T>(std::ldexp(vector.x(), exponent), std::ldexp(vector.y(), exponent),
+                       std::ldexp(vector.z(), exponent));
+}
+
+template <class T>
+Matrix3T<T> Gram(const Matrix3T<T>& matrix) {
+    return matrix.transpose().product(matrix);
+}
+
+// Rotates columns |i| and |j| of every lane of |m| by the per-lane c[lane], s[lane].
+template <class T, size_t W>
+__attribute__((always_inline)) inline void RotateColumns(T m[3][3][W], const int i, const int j, const T c[W],
+                                                         const T s[W]) {
+    for (int row = 0; row < 3; ++row) {
+        for (size_t lane = 0; lane < W; ++lane) {
+            const T mi = m[row][i][lane];
+            const T mj = m[row][j][lane];
+            m[row][i][lane] = c[lane] * mi - s[lane] * mj;
+            m[row][j][lane] = s[lane] * mi + c[lane] * mj;
+        }
+    }
+}
+
+// One sweep of one-sided Jacobi: rotates pairs of columns of |b| until they are orthogonal,
+// applying the same rotations to the columns of |v|. V from the Gram matrix is off by up to
+// eps * (s1 / s) for a singular value s, which would leave that much in the off-diagonal of R;
+// starting this close to orthogonal, one sweep brings it down to eps. Lanes step in lockstep
+// and vectorize like Jacobi() in symmetric_eigen.cc: a lane whose pair is already orthogonal
+// gets the identity rotation, and a pair is skipped only when it is orthogonal in every lane,
+// which is the common case.
+template <class T, size_t W>
+__attribute__((always_inline)) inline void OrthogonalizeColumns(T b[3][3][W], T v[3][3][W]) {
+    static constexpr int kPairs[3][2]{{0, 1}, {0, 2}, {1, 2}};
+#pragma GCC unroll 3
+    for (const auto& pair : kPairs) {
+        const int i = pair[0];
+        const int j = pair[1];
+        T t[W];
+#pragma GCC unroll 1
+        for (size_t lane = 0; lane < W; ++lane) {
+            const T alpha = b[0][i][lane] * b[0][i][lane] + b[1][i][lane] * b[1][i][lane] + b[2][i][lane] * b[2][i][lane];
+            const T beta = b[0][j][lane] * b[0][j][lane] + b[1][j][lane] * b[1][j][lane] + b[2][j][lane] * b[2][j][lane];
+            const T gamma = b[0][i][lane] * b[0][j][lane] + b[1][i][lane] * b[1][j][lane] + b[2][i][lane] * b[2][j][lane];
+            // Already orthogonal to working precision: R then gets less than eps * |b_j| off
+            // its diagonal.
+            const bool orthogonal =
+                std::fabs(gamma) <= std::numeric_limits<T>::epsilon() * std::sqrt(alpha) * std::sqrt(beta);
+            // Same rotation as the symmetric eigen-solver uses on [[alpha, gamma], [gamma, beta]].
+            const T d = beta - alpha;
+            const T root = std::sqrt(d * d + 4 * gamma * gamma);
+            const T tangent = 2 * gamma / (std::fabs(d) + root) * (d < 0 ? T(-1) : T(1));
+            t[lane] = orthogonal ? T(0) : tangent;
+        }
+        bool any{false};
+        for (size_t lane = 0; lane < W; ++lane) {
+            any |= t[lane] != 0;
+        }
+        if (!any) {
+            continue;
+        }
+        T c[W];
+        T s[W];
+#pragma GCC unroll 1
+        for (size_t lane = 0; lane < W; ++lane) {
+            c[lane] = 1 / std::sqrt(t[lane] * t[lane] + 1);
+            s[lane] = t[lane] * c[lane];
+        }
+        RotateColumns<T, W>(b, i, j, c, s);
+        RotateColumns<T, W>(v, i, j, c, s);
+    }
+}
+
+// Zeroes b[q][column] in every lane with a rotation of rows p and q of |b|, and applies the
+// same rotation to the rows of |qt|. Leaves b[p][column] = hypot(b[p][column], b[q][column]).
+// Where both are zero, adding one to x and r makes it the identity rotation without a branch.
+template <class T, size_t W>
+__attribute__((always_inline)) inline void Givens(T b[3][3][W], T qt[3][3][W], const int p, const int q,
+                                                  const int column) {
+    for (size_t lane = 0; lane < W; ++lane) {
+        const T x = b[p][column][lane];
+        const T y = b[q][column][lane];
+        const T r = std::sqrt(x * x + y * y);
+        const T zero = r == 0 ? T(1) : T(0);
+        const T inverse = 1 / (r + zero);
+        const T c = (x + zero) * inverse;
+        const T s = y * inverse;
+        for (int k = 0; k < 3; ++k) {
+            const T bp = b[p][k][lane];
+            const T bq = b[q][k][lane];
+            b[p][k][lane] = bp * c + bq * s;
+            b[q][k][lane] = bq * c - bp * s;
+            const T qp = qt[p][k][lane];
+            const T qq = qt[q][k][lane];
+            qt[p][k][lane] = qp * c + qq * s;
+            qt[q][k][lane] = qq * c - qp * s;
+        }
+    }
+}
+
+// Completes the decomposition of matrices [0, W) from the eigenvectors of their Gram matrices.
+// Every stage runs on all lanes at once without branching on their data.
+template <class T, size_t W>
+__attribute__((always_inline)) inline void FinishGroup(const Matrix3T<T>* matrices, const EigenDecompositionT<T>* eigen,
+                                                       SvdT<T>* out) {
+    T b[3][3][W];
+    T v[3][3][W];
+    T qt[3][3][W];
+    for (size_t lane = 0; lane < W; ++lane) {
+        const Matrix3T<T>& vectors = eigen[lane].vectors;
+        for (uint32_t row = 0; row < 3; ++row) {
+            // Descending order. Reversing the columns flips the orientation, negating one
+            // restores it.
+            v[row][0][lane] = vectors[row][2];
+            v[row][1][lane] = vectors[row][1];
+            v[row][2][lane] = -vectors[row][0];
+            for (int column = 0; column < 3; ++column) {
+                qt[row][column][lane] = row == static_cast<uint32_t>(column) ? T(1) : T(0);
+            }
+        }
+    }
+    // QR of A * V. Its columns are orthogonal, so R comes out diagonal up to rounding.
+    for (size_t lane = 0; lane < W; ++lane) {
+        const Matrix3T<T>& a = matrices[lane];
+        for (uint32_t row = 0; row < 3; ++row) {
+            for (int column = 0; column < 3; ++column) {
+                b[row][column][lane] = a[row][0] * v[0][column][lane] + a[row][1] * v[1][column][lane] +
+                                       a[row][2] * v[2][column][lane];
+            }
+        }
+    }
+    OrthogonalizeColumns<T, W>(b, v);
+    Givens<T, W>(b, qt, 0, 1, 0);
+    Givens<T, W>(b, qt, 0, 2, 0);
+    Givens<T, W>(b, qt, 1, 2, 1);
+    for (size_t lane = 0; lane < W; ++lane) {
+        // U = Q = qt^T.
+        out[lane].u = Matrix3T<T>(Vector3T<T>(qt[0][0][lane], qt[1][0][lane], qt[2][0][lane]),
+                                  Vector3T<T>(qt[0][1][lane], qt[1][1][lane], qt[2][1][lane]),
+                                  Vector3T<T>(qt[0][2][lane], qt[1][2][lane], qt[2][2][lane]));
+        out[lane].values = Vector3T<T>(b[0][0][lane], b[1][1][lane], b[2][2][lane]);
+        out[lane].v = Matrix3T<T>(Vector3T<T>(v[0][0][lane], v[0][1][lane], v[0][2][lane]),
+                                  Vector3T<T>(v[1][0][lane], v[1][1][lane], v[1][2][lane]),
+                                  Vector3T<T>(v[2][0][lane], v[2][1][lane], v[2][2][lane]));
+    }
+}
+
+}  // namespace
+
+template <class T>
+SvdT<T> ComputeSvd(const Matrix3T<T>& matrix) {
+    const int exponent = ScaleExponent(matrix);
+    if (exponent != 0) {
+        SvdT<T> result = ComputeSvd(Ldexp(matrix, -exponent));
+        result.values = Ldexp(result.values, exponent);
+        return result;
+    }
+    const EigenDecompositionT<T> eigen = EigenDecompose(Gram(matrix));
+    SvdT<T> result;
+    FinishGroup<T, 1>(&matrix, &eigen, &result);
+    return result;
+}
+
+template <class T>
+void ComputeSvdBatch(const Matrix3T<T>* matrices, SvdT<T>* out, size_t count) {
+    Matrix3T<T> scaled[kBatchChunk];
+    int exponents[kBatchChunk];
+    Matrix3T<T> grams[kBatchChunk];
+    EigenDecompositionT<T> eigen[kBatchChunk];
+    for (size_t begin = 0; begin < count; begin += kBatchChunk) {
+        const size_t size = std::min(kBatchChunk, count - begin);
+        for (size_t i = 0; i < size; ++i) {
+            exponents[i] = ScaleExponent(matrices[begin + i]);
+            scaled[i] = exponents[i] == 0 ? matrices[begin + i] : Ldexp(matrices[begin + i], -exponents[i]);
+            grams[i] = Gram(scaled[i]);
+        }
+        EigenDecomposeBatch(grams, eigen, size);
+        size_t i = 0;
+        for (; i + kGroupSize<T> <= size; i += kGroupSize<T>) {
+            FinishGroup<T, kGroupSize<T>>(scaled + i, eigen + i, out + begin + i);
+        }
+        for (; i < size; ++i) {
+            FinishGroup<T, 1>(scaled + i, eigen + i, out + begin + i);
+        }
+        for (i = 0; i < size; ++i) {
+            if (exponents[i] != 0) {
+                out[begin + i].values = Ldexp(out[begin + i].values, exponents[i]);
+            }
+        }
+    }
+}
+
+template <class T>
+PolarT<T> PolarDecompose(const Matrix3T<T>& matrix) {
+    const SvdT<T> svd = ComputeSvd(matrix);
+    const Matrix3T<T> vt = svd.v.transpose();
+    const Matrix3T<T> scaled_vt(vt.r1() * svd.values.x(), vt.r2() * svd.values.y(), vt.r3() * svd.values.z());
+    return PolarT<T>{svd.u.product(vt), svd.v.product(scaled_vt)};
+}
+
+template <class T>
+Matrix3T<T> NearestRotation(const Matrix3T<T>& matrix) {
+    const SvdT<T> svd = ComputeSvd(matrix);
+    return svd.u.product(svd.v.transpose());
+}
+
+// Supported scalar types.
+template SvdT<double> ComputeSvd<double>(const Matrix3T<double>& matrix);
+template SvdT<float> ComputeSvd<float>(const Matrix3T<float>& matrix);
+template void ComputeSvdBatch<double>(const Matrix3T<double>* matrices, SvdT<double>* out, size_t count);
+template void ComputeSvdBatch<float>(const Matrix3T<float>* matrices, SvdT<float>* out, size_t count);
+template PolarT<double> PolarDecompose<double>(const Matrix3T<double>& matrix);
+template PolarT<float> PolarDecompose<float>(const Matrix3T<float>& matrix);
+template Matrix3T<double> NearestRotation<double>(const Matrix3T<double>& matrix);
+template Matrix3T<float> NearestRotation<float>(const Matrix3T<float>& matrix);
+
+}  // namespace math
+}  // namespace ekumen
@@ -0,0 +1,195 @@
+#include "symmetric_eigen.h"
+
+#include <cmath>
+#include <limits>
+#include <utility>
+
+namespace ekumen {
+namespace math {
+namespace {
+
+// Far more than Jacobi needs on 3x3 matrices, just a bound for NaN input.
+constexpr int kMaxSweeps{16};
+constexpr int kPairs[3][2]{{0, 1}, {0, 2}, {1, 2}};
+
+// Diagonalizes W symmetric matrices at once with plane rotations, accumulating them into |v|.
+// Element [i][j][lane] belongs to matrix |lane|. Lanes step in lockstep without branching on
+// their own data: a lane whose a[p][q] is already negligible gets the identity rotation,
+// t = 0, which leaves it unchanged up to the sign of zeros. The sweeps stop once no lane
+// rotated, so every lane gets the same rotations whatever group it runs in.
+//
+// The lane loops are written for the vectorizer: the pairs are unrolled so p and q are
+// constants, the lane loops are kept rolled so the loop vectorizer rather than the straight
+// line one sees them, both square roots are taken and one selected, and whether any lane
+// rotates is read off t after the loop rather than reduced inside it.
+template <class T, size_t W>
+__attribute__((always_inline)) inline void Jacobi(T a[3][3][W], T v[3][3][W]) {
+    for (int sweep = 0; sweep < kMaxSweeps; ++sweep) {
+        bool rotated{false};
+#pragma GCC unroll 3
+        for (const auto& pair : kPairs) {
+            const int p = pair[0];
+            const int q = pair[1];
+            const int r = 3 - p - q;
+            T t[W];
+#pragma GCC unroll 1
+            for (size_t lane = 0; lane < W; ++lane) {
+                const T apq = a[p][q][lane];
+                // Negligible against the diagonal it couples. Comparing against the diagonal
+                // rather than the whole matrix keeps the small eigenvalues accurate too.
+                // Comparing square roots rather than squares keeps it in range at any scale.
+                const bool negligible = std::fabs(apq) <= std::numeric_limits<T>::epsilon() *
+                                                              std::sqrt(std::fabs(a[p][p][lane])) *
+                                                              std::sqrt(std::fabs(a[q][q][lane]));
+                // tan of the smaller rotation angle that zeroes a[p][q]:
+                // t = 2 apq / (d + sign(d) sqrt(d^2 + 4 apq^2)) with d = aqq - app.
+                const T d = a[q][q][lane] - a[p][p][lane];
+                // The squares overflow above about sqrt(max) and go subnormal below about
+                // sqrt(min). Both ends are recomputed scaled.
+                const T radicand = d * d + 4 * apq * apq;
+                const T scale = std::fabs(d) + std::fabs(apq);
+                const T inverse = 1 / scale;
+                const T scaled_root =
+                    scale * std::sqrt((d * inverse) * (d * inverse) + 4 * (apq * inverse) * (apq * inverse));
+                const bool out_of_range = !(radicand >= std::numeric_limits<T>::min() &&
+                                            radicand <= std::numeric_limits<T>::max());
+                const T root = out_of_range ? scaled_root : std::sqrt(radicand);
+                const T tangent = 2 * apq / (std::fabs(d) + root) * (d < 0 ? T(-1) : T(1));
+                t[lane] = negligible ? T(0) : tangent;
+            }
+            bool any{false};
+            for (size_t lane = 0; lane < W; ++lane) {
+                any |= t[lane] != 0;
+            }
+            if (!any) {
+                for (size_t lane = 0; lane < W; ++lane) {
+                    a[p][q][lane] = a[q][p][lane] = 0;
+                }
+                continue;
+            }
+            rotated = true;
+#pragma GCC unroll 1
+            for (size_t lane = 0; lane < W; ++lane) {
+                const T c = 1 / std::sqrt(t[lane] * t[lane] + 1);
+                const T s = t[lane] * c;
+                const T h = t[lane] * a[p][q][lane];
+                a[p][p][lane] -= h;
+                a[q][q][lane] += h;
+                a[p][q][lane] = a[q][p][lane] = 0;
+                const T arp = a[r][p][lane];
+                const T arq = a[r][q][lane];
+                a[r][p][lane] = a[p][r][lane] = c * arp - s * arq;
+                a[r][q][lane] = a[q][r][lane] = s * arp + c * arq;
+                for (int row = 0; row < 3; ++row) {
+                    const T vp = v[row][p][lane];
+                    const T vq = v[row][q][lane];
+                    v[row][p][lane] = c * vp - s * vq;
+                    v[row][q][lane] = s * vp + c * vq;
+                }
+            }
+        }
+        if (!rotated) {
+            break;
+        }
+    }
+}
+
+template <class T>
+__attribute__((always_inline)) inline void SwapColumns(T v[3][3], T values[3], const int i, const int j) {
+    std::swap(values[i], values[j]);
+    for (int row = 0; row < 3; ++row) {
+        std::swap(v[row][i], v[row][j]);
+    }
+}
+
+// Sorts the eigenpairs of one diagonalized matrix and writes them out.
+template <class T>
+__attribute__((always_inline)) inline void Finish(T values[3], T v[3][3], EigenDecompositionT<T>* out) {
+    if (values[1] < values[0]) {
+        SwapColumns(v, values, 0, 1);
+    }
+    if (values[2] < values[1]) {
+        SwapColumns(v, values, 1, 2);
+        if (values[1] < values[0]) {
+            SwapColumns(v, values, 0, 1);
+        }
+    }
+    // Each swap flips the orientation, make the basis right handed again.
+    const T det = v[0][0] * (v[1][1] * v[2][2] - v[1][2] * v[2][1]) -
+                  v[0][1] * (v[1][0] * v[2][2] - v[1][2] * v[2][0]) +
+                  v[0][2] * (v[1][0] * v[2][1] - v[1][1] * v[2][0]);
+    if (det < 0) {
+        for (int row = 0; row < 3; ++row) {
+            v[row][2] = -v[row][2];
+        }
+    }
+    out->values = Vector3T<T>(values[0], values[1], values[2]);
+    out->vectors = Matrix3T<T>(Vector3T<T>(v[0][0], v[0][1], v[0][2]), Vector3T<T>(v[1][0], v[1][1], v[1][2]),
+                               Vector3T<T>(v[2][0], v[2][1], v[2][2]));
+}
+
+// Decomposes matrices [0, W).
+template <class T, size_t W>
+__attribute__((always_inline)) inline void DecomposeGroup(const Matrix3T<T>* matrices, EigenDecompositionT<T>* out) {
+    T a[3][3][W];
+    T v[3][3][W];
+    for (size_t lane = 0; lane < W; ++lane) {
+        const Vector3T<T>& r1 = matrices[lane].r1();
+        const Vector3T<T>& r2 = matrices[lane].r2();
+        const Vector3T<T>& r3 = matrices[lane].r3();
+        const T upper[3][3]{{r1.x(), r1.y(), r1.z()}, {r1.y(), r2.y(), r2.z()}, {r1.z(), r2.z(), r3.z()}};
+        for (int row = 0; row < 3; ++row) {
+            for (int column = 0; column < 3; ++column) {
+                a[row][column][lane] = upper[row][column];
+                v[row][column][lane] = row == column ? T(1) : T(0);
+            }
+        }
+    }
+    Jacobi<T, W>(a, v);
+    for (size_t lane = 0; lane < W; ++lane) {
+        T values[3]{a[0][0][lane], a[1][1][lane], a[2][2][lane]};
+        T vectors[3][3];
+        for (int row = 0; row < 3; ++row) {
+            for (int column = 0; column < 3; ++column) {
+                vectors[row][column] = v[row][column][lane];
+            }
+        }
+        Finish(values, vectors, &out[lane]);
+    }
+}
+
+// Matrices per group in the batch: two SSE registers wide, so each vectorized lane loop
+// keeps two independent square roots or divisions in flight.
+template <class T>
+constexpr size_t kGroupSize{32 / sizeof(T)};
+
+}  // namespace
+
+template <class T>
+EigenDecompositionT<T> EigenDecompose(const Matrix3T<T>& matrix) {
+    EigenDecompositionT<T> result;
+    DecomposeGroup<T, 1>(&matrix, &result);
+    return result;
+}
+
+template <class T>
+void EigenDecomposeBatch(const Matrix3T<T>* matrices, EigenDecompositionT<T>* out, size_t count) {
+    size_t i = 0;
+    for (; i + kGroupSize<T> <= count; i += kGroupSize<T>) {
+        DecomposeGroup<T, kGroupSize<T>>(matrices + i, out + i);
+    }
+    for (; i < count; ++i) {
+        DecomposeGroup<T, 1>(matrices + i, out + i);
+    }
+}
+
+// Supported scalar types.
+template EigenDecompositionT<double> EigenDecompose<double>(const Matrix3T<double>& matrix);
+template EigenDecompositionT<float> EigenDecompose<float>(const Matrix3T<float>& matrix);
+template void EigenDecomposeBatch<double>(const Matrix3T<double>* matrices, EigenDecompositionT<double>* out,
+                                          size_t count);
+template void EigenDecomposeBatch<float>(const Matrix3T<float>* matrices, EigenDecompositionT<float>* out,
+                                         size_t count);
+
+}  // namespace math
+}  // namespace ekumen
@@ -0,0 +1,793 @@
+#include "text_format.h"
+
+#include <locale.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <type_traits>
+
+#include "isometry.h"
+
+namespace ekumen {
+namespace math {
+namespace {
+
+// Shortest digits ----------------------------------------------------------------------------
+//
+// Grisu3, from F. Loitsch, "Printing Floating-Point Numbers Quickly and Accurately with
+// Integers" (PLDI 2010). The value and the bounds of its rounding interval are scaled by a
+// cached power of ten into 64 bit integers, and digits are generated until the remainder falls
+// inside the interval. The scaled values are off by at most one unit, so the digits are only
+// accepted when that error cannot matter; for the roughly 0.5% of inputs where it can, the
+// digits are recomputed exactly with big integers (Burger and Dybvig's free-format algorithm).
+// Either way the result is the shortest string that parses back to the value, and of those the
+// closest to it.
+
+// f * 2^e
+struct DiyFp {
+    uint64_t f;
+    int e;
+};
+
+// Upper 64 bits of the 128 bit product, rounded.
+DiyFp Multiply(const DiyFp& x, const DiyFp& y) {
+    const unsigned __int128 product = static_cast<unsigned __int128>(x.f) * y.f;
+    const uint64_t high = static_cast<uint64_t>(product >> 64);
+    const uint64_t low = static_cast<uint64_t>(product);
+    return DiyFp{high + (low >> 63), x.e + y.e + 64};
+}
+
+DiyFp Normalize(const DiyFp& x) {
+    const int shift = __builtin_clzll(x.f);
+    return DiyFp{x.f << shift, x.e - shift};
+}
+
+DiyFp NormalizeTo(const DiyFp& x, const int e) {
+    return DiyFp{x.f << (x.e - e), e};
+}
+
+// |value| == f * 2^e, with the hidden bit of normal numbers included in f.
+struct Decomposed {
+    uint64_t f;
+    int e;
+    // At a power of two the next value down is half as far away as the next one up.
+    bool lower_is_closer;
+};
+
+// |value| must be finite and positive.
+template <class T>
+Decomposed Decompose(const T value) {
+    using Bits = typename std::conditional<sizeof(T) == 8, uint64_t, uint32_t>::type;
+    constexpr int kSignificandBits{std::numeric_limits<T>::digits - 1};
+    constexpr int kBias{std::numeric_limits<T>::max_exponent - 1 + kSignificandBits};
+    constexpr uint64_t kHiddenBit{uint64_t{1} << kSignificandBits};
+
+    Bits bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    const uint64_t exponent = bits >> kSignificandBits;
+    const uint64_t fraction = bits & (kHiddenBit - 1);
+    if (exponent == 0) {
+        return Decomposed{fraction, 1 - kBias, false};
+    }
+    return Decomposed{fraction + kHiddenBit, static_cast<int>(exponent) - kBias, fraction == 0 && exponent > 1};
+}
+
+// The value and the boundaries m- and m+ of its rounding interval, normalized so that all
+// three share the exponent of m+.
+struct Boundaries {
+    DiyFp w;
+    DiyFp minus;
+    DiyFp plus;
+};
+
+Boundaries ComputeBoundaries(const Decomposed& v) {
+    const DiyFp plus = Normalize(DiyFp{2 * v.f + 1, v.e - 1});
+    const DiyFp minus = v.lower_is_closer ? DiyFp{4 * v.f - 1, v.e - 2} : DiyFp{2 * v.f - 1, v.e - 1};
+    return Boundaries{Normalize(DiyFp{v.f, v.e}), NormalizeTo(minus, plus.e), plus};
+}
+
+// 10^k ~= f * 2^e, for every eighth k from -300 to 324.
+struct CachedPower {
+    uint64_t f;
+    int e;
+    int k;
+};
+
+constexpr CachedPower kCachedPowers[] = {
+    {0xAB70FE17C79AC6CA, -1060, -300},
+    {0xFF77B1FCBEBCDC4F, -1034, -292},
+    {0xBE5691EF416BD60C, -1007, -284},
+    {0x8DD01FAD907FFC3C, -980, -276},
+    {0xD3515C2831559A83, -954, -268},
+    {0x9D71AC8FADA6C9B5, -927, -260},
+    {0xEA9C227723EE8BCB, -901, -252},
+    {0xAECC49914078536D, -874, -244},
+    {0x823C12795DB6CE57, -847, -236},
+    {0xC21094364DFB5637, -821, -228},
+    {0x9096EA6F3848984F, -794, -220},
+    {0xD77485CB25823AC7, -768, -212},
+    {0xA086CFCD97BF97F4, -741, -204},
+    {0xEF340A98172AACE5, -715, -196},
+    {0xB23867FB2A35B28E, -688, -188},
+    {0x84C8D4DFD2C63F3B, -661, -180},
+    {0xC5DD44271AD3CDBA, -635, -172},
+    {0x936B9FCEBB25C996, -608, -164},
+    {0xDBAC6C247D62A584, -582, -156},
+    {0xA3AB66580D5FDAF6, -555, -148},
+    {0xF3E2F893DEC3F126, -529, -140},
+    {0xB5B5ADA8AAFF80B8, -502, -132},
+    {0x87625F056C7C4A8B, -475, -124},
+    {0xC9BCFF6034C13053, -449, -116},
+    {0x964E858C91BA2655, -422, -108},
+    {0xDFF9772470297EBD, -396, -100},
+    {0xA6DFBD9FB8E5B88F, -369, -92},
+    {0xF8A95FCF88747D94, -343, -84},
+    {0xB94470938FA89BCF, -316, -76},
+    {0x8A08F0F8BF0F156B, -289, -68},
+    {0xCDB02555653131B6, -263, -60},
+    {0x993FE2C6D07B7FAC, -236, -52},
+    {0xE45C10C42A2B3B06, -210, -44},
+    {0xAA242499697392D3, -183, -36},
+    {0xFD87B5F28300CA0E, -157, -28},
+    {0xBCE5086492111AEB, -130, -20},
+    {0x8CBCCC096F5088CC, -103, -12},
+    {0xD1B71758E219652C, -77, -4},
+    {0x9C40000000000000, -50, 4},
+    {0xE8D4A51000000000, -24, 12},
+    {0xAD78EBC5AC620000, 3, 20},
+    {0x813F3978F8940984, 30, 28},
+    {0xC097CE7BC90715B3, 56, 36},
+    {0x8F7E32CE7BEA5C70, 83, 44},
+    {0xD5D238A4ABE98068, 109, 52},
+    {0x9F4F2726179A2245, 136, 60},
+    {0xED63A231D4C4FB27, 162, 68},
+    {0xB0DE65388CC8ADA8, 189, 76},
+    {0x83C7088E1AAB65DB, 216, 84},
+    {0xC45D1DF942711D9A, 242, 92},
+    {0x924D692CA61BE758, 269, 100},
+    {0xDA01EE641A708DEA, 295, 108},
+    {0xA26DA3999AEF774A, 322, 116},
+    {0xF209787BB47D6B85, 348, 124},
+    {0xB454E4A179DD1877, 375, 132},
+    {0x865B86925B9BC5C2, 402, 140},
+    {0xC83553C5C8965D3D, 428, 148},
+    {0x952AB45CFA97A0B3, 455, 156},
+    {0xDE469FBD99A05FE3, 481, 164},
+    {0xA59BC234DB398C25, 508, 172},
+    {0xF6C69A72A3989F5C, 534, 180},
+    {0xB7DCBF5354E9BECE, 561, 188},
+    {0x88FCF317F22241E2, 588, 196},
+    {0xCC20CE9BD35C78A5, 614, 204},
+    {0x98165AF37B2153DF, 641, 212},
+    {0xE2A0B5DC971F303A, 667, 220},
+    {0xA8D9D1535CE3B396, 694, 228},
+    {0xFB9B7CD9A4A7443C, 720, 236},
+    {0xBB764C4CA7A44410, 747, 244},
+    {0x8BAB8EEFB6409C1A, 774, 252},
+    {0xD01FEF10A657842C, 800, 260},
+    {0x9B10A4E5E9913129, 827, 268},
+    {0xE7109BFBA19C0C9D, 853, 276},
+    {0xAC2820D9623BF429, 880, 284},
+    {0x80444B5E7AA7CF85, 907, 292},
+    {0xBF21E44003ACDD2D, 933, 300},
+    {0x8E679C2F5E44FF8F, 960, 308},
+    {0xD433179D9C8CB841, 986, 316},
+    {0x9E19DB92B4E31BA9, 1013, 324},
+};
+
+// Range of binary exponents the scaled values are brought into, so that the integral part of
+// m+ fits in 32 bits.
+constexpr int kAlpha{-60};
+constexpr int kGamma{-32};
+
+// Returns the cached power c such that kAlpha <= c.e + e + 64 <= kGamma.
+const CachedPower& CachedPowerFor(const int e) {
+    // k = ceil((kAlpha - e - 1) * log10(2)), computed with a fixed point approximation.
+    const int f = kAlpha - e - 1;
+    const int k = (f * 78913) / (1 << 18) + (f > 0);
+    return kCachedPowers[(300 + k + 7) / 8];
+}
+
+// Decrements the last digit while that brings the digits closer to w and keeps them inside
+// the interval. |unit| is the uncertainty of the scaled values: returns false when it leaves
+// open which digit is closest, or whether the digits are inside the interval at all.
+bool RoundWeed(char* digits, const int length, const uint64_t distance, const uint64_t delta, uint64_t rest,
+               const uint64_t ten_k, const uint64_t unit) {
+    const uint64_t small_distance = distance - unit;
+    const uint64_t big_distance = distance + unit;
+    while (rest < small_distance && delta - rest >= ten_k &&
+           (rest + ten_k < small_distance || small_distance - rest >= rest + ten_k - small_distance)) {
+        --digits[length - 1];
+        rest += ten_k;
+    }
+    if (rest < big_distance && delta - rest >= ten_k &&
+        (rest + ten_k < big_distance || big_distance - rest > rest + ten_k - big_distance)) {
+        return false;
+    }
+    return 2 * unit <= rest && rest <= delta - 4 * unit;
+}
+
+// Generates the digits of m+, widened by the error of the scaling, until they fall within the
+// widened interval. Stores the number of digits in |length| and adds the position of the last
+// one to |exponent|. Returns false if the digits are not provably shortest and closest.
+bool GenerateDigits(const DiyFp& minus, const DiyFp& w, const DiyFp& plus, char* digits, int* length,
+                    int* exponent) {
+    uint64_t unit = 1;
+    const uint64_t too_high = plus.f + unit;
+    uint64_t delta = too_high - (minus.f - unit);
+    uint64_t distance = too_high - w.f;
+    const int shift = -plus.e;
+    const uint64_t one = uint64_t{1} << shift;
+    uint32_t integral = static_cast<uint32_t>(too_high >> shift);
+    uint64_t fractional = too_high & (one - 1);
+
+    uint32_t divisor = 1;
+    int remaining = 1;
+    while (integral / divisor >= 10) {
+        divisor *= 10;
+        ++remaining;
+    }
+    *length = 0;
+    while (remaining > 0) {
+        digits[(*length)++] = static_cast<char>('0' + integral / divisor);
+        integral %= divisor;
+        --remaining;
+        const uint64_t rest = (static_cast<uint64_t>(integral) << shift) + fractional;
+        if (rest < delta) {
+            *exponent += remaining;
+            return RoundWeed(digits, *length, distance, delta, rest, static_cast<uint64_t>(divisor) << shift, unit);
+        }
+        divisor /= 10;
+    }
+    while (true) {
+        fractional *= 10;
+        unit *= 10;
+        delta *= 10;
+        distance *= 10;
+        digits[(*length)++] = static_cast<char>('0' + (fractional >> shift));
+        fractional &= one - 1;
+        --*exponent;
+        if (fractional < delta) {
+            return RoundWeed(digits, *length, distance, delta, fractional, one, unit);
+        }
+    }
+}
+
+// Unsigned integer of fixed capacity for the exact fallback. The scaled values stay below
+// 2^1140, reached for subnormal doubles.
+struct BigInt {
+    static constexpr int kCapacity{40};
+    uint32_t limbs[kCapacity];
+    int size;
+};
+
+BigInt MakeBigInt(const uint64_t value) {
+    BigInt result;
+    result.limbs[0] = static_cast<uint32_t>(value);
+    result.limbs[1] = static_cast<uint32_t>(value >> 32);
+    result.size = result.limbs[1] != 0 ? 2 : result.limbs[0] != 0 ? 1 : 0;
+    return result;
+}
+
+void ShiftLeft(BigInt* x, const int bits) {
+    const int limbs = bits / 32;
+    const int shift = bits % 32;
+    uint32_t carry = 0;
+    for (int i = x->size - 1; i >= 0; --i) {
+        const uint64_t wide = static_cast<uint64_t>(x->limbs[i]) << shift;
+        if (i == x->size - 1) {
+            carry = static_cast<uint32_t>(wide >> 32);
+        }
+        x->limbs[i + limbs] = static_cast<uint32_t>(wide) | (i > 0 && shift > 0 ? x->limbs[i - 1] >> (32 - shift) : 0);
+    }
+    std::fill(x->limbs, x->limbs + limbs, 0);
+    x->size += limbs;
+    if (carry != 0) {
+        x->limbs[x->size++] = carry;
+    }
+}
+
+void MultiplySmall(BigInt* x, const uint32_t factor) {
+    uint64_t carry = 0;
+    for (int i = 0; i < x->size; ++i) {
+        const uint64_t product = static_cast<uint64_t>(x->limbs[i]) * factor + carry;
+        x->limbs[i] = static_cast<uint32_t>(product);
+        carry = product >> 32;
+    }
+    if (carry != 0) {
+        x->limbs[x->size++] = static_cast<uint32_t>(carry);
+    }
+}
+
+void MultiplyPow10(BigInt* x, int exponent) {
+    for (; exponent >= 9; exponent -= 9) {
+        MultiplySmall(x, 1000000000);
+    }
+    constexpr uint32_t kPowers[] = {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000};
+    MultiplySmall(x, kPowers[exponent]);
+}
+
+int Compare(const BigInt& a, const BigInt& b) {
+    if (a.size != b.size) {
+        return a.size < b.size ? -1 : 1;
+    }
+    for (int i = a.size - 1; i >= 0; --i) {
+        if (a.limbs[i] != b.limbs[i]) {
+            return a.limbs[i] < b.limbs[i] ? -1 : 1;
+        }
+    }
+    return 0;
+}
+
+// Compares a + b with c.
+int PlusCompare(const BigInt& a, const BigInt& b, const BigInt& c) {
+    BigInt sum;
+    uint64_t carry = 0;
+    sum.size = std::max(a.size, b.size);
+    for (int i = 0; i < sum.size; ++i) {
+        carry += static_cast<uint64_t>(i < a.size ? a.limbs[i] : 0) + (i < b.size ? b.limbs[i] : 0);
+        sum.limbs[i] = static_cast<uint32_t>(carry);
+        carry >>= 32;
+    }
+    if (carry != 0) {
+        sum.limbs[sum.size++] = static_cast<uint32_t>(carry);
+    }
+    return Compare(sum, c);
+}
+
+// a -= b, with a >= b.
+void Subtract(BigInt* a, const BigInt& b) {
+    int64_t borrow = 0;
+    for (int i = 0; i < a->size; ++i) {
+        borrow += static_cast<int64_t>(a->limbs[i]) - (i < b.size ? b.limbs[i] : 0);
+        a->limbs[i] = static_cast<uint32_t>(borrow);
+        borrow >>= 32;
+    }
+    while (a->size > 0 && a->limbs[a->size - 1] == 0) {
+        --a->size;
+    }
+}
+
+// Burger and Dybvig, "Printing Floating-Point Numbers Quickly and Accurately" (PLDI 1996):
+// the value is r / s and the interval reaches m- below and m+ above it, all exact. A parser
+// rounding to even reads back the ends of the interval when f is even, so they count as inside.
+int ExactShortestDigits(const Decomposed& v, char* digits, int* exponent) {
+    const int shift = v.lower_is_closer ? 2 : 1;
+    BigInt r = MakeBigInt(v.f);
+    BigInt s = MakeBigInt(1);
+    BigInt minus = MakeBigInt(1);
+    ShiftLeft(&r, shift + std::max(v.e, 0));
+    ShiftLeft(&s, shift - std::min(v.e, 0));
+    ShiftLeft(&minus, std::max(v.e, 0));
+    BigInt plus = minus;
+    if (v.lower_is_closer) {
+        ShiftLeft(&plus, 1);
+    }
+    const bool inclusive = v.f % 2 == 0;
+
+    // ceil(log10(v)), or one less.
+    const int bits = 64 - __builtin_clzll(v.f);
+    int k = static_cast<int>(std::ceil((v.e + bits - 1) * 0.30102999566398114 - 1e-10));
+    if (k >= 0) {
+        MultiplyPow10(&s, k);
+    } else {
+        MultiplyPow10(&r, -k);
+        MultiplyPow10(&minus, -k);
+        MultiplyPow10(&plus, -k);
+    }
+    if (PlusCompare(r, plus, s) >= (inclusive ? 0 : 1)) {
+        MultiplySmall(&s, 10);
+        ++k;
+    }
+
+    int length = 0;
+    while (true) {
+        MultiplySmall(&r, 10);
+        MultiplySmall(&minus, 10);
+        MultiplySmall(&plus, 10);
+        char digit = '0';
+        while (Compare(r, s) >= 0) {
+            Subtract(&r, s);
+            ++digit;
+        }
+        const bool low = Compare(r, minus) < (inclusive ? 1 : 0);
+        const bool high = PlusCompare(r, plus, s) >= (inclusive ? 0 : 1);
+        if (low && high) {
+            // Both neighbours are inside: take the closer one, the even one on a tie.
+            const int half = PlusCompare(r, r, s);
+            digit += half > 0 || (half == 0 && (digit - '0') % 2 == 1);
+        } else if (high) {
+            ++digit;
+        }
+        digits[length++] = digit;
+        if (low || high) {
+            break;
+        }
+    }
+    *exponent = k - length;
+    return length;
+}
+
+// Writes the shortest digits of |value|, which must be finite and positive, so that
+// value == digits * 10^exponent. Returns the number of digits, at most 17.
+template <class T>
+int ShortestDigits(const T value, char* digits, int* exponent) {
+    const Decomposed decomposed = Decompose(value);
+    const Boundaries boundaries = ComputeBoundaries(decomposed);
+    const CachedPower& cached = CachedPowerFor(boundaries.plus.e);
+    const DiyFp power{cached.f, cached.e};
+    const DiyFp w = Multiply(boundaries.w, power);
+    const DiyFp minus = Multiply(boundaries.minus, power);
+    const DiyFp plus = Multiply(boundaries.plus, power);
+    int length;
+    *exponent = -cached.k;
+    if (GenerateDigits(minus, w, plus, digits, &length, exponent)) {
+        return length;
+    }
+    return ExactShortestDigits(decomposed, digits, exponent);
+}
+
+// Text ---------------------------------------------------------------------------------------
+
+// Fixed notation is used while the decimal point is at most this many digits right of the
+// leading digit, and less than four zeros left of it.
+constexpr int kMaxFixedDigits{17};
+
+template <size_t N>
+char* Append(char* out, const char (&text)[N]) {
+    std::memcpy(out, text, N - 1);
+    return out + N - 1;
+}
+
+char* AppendDigits(char* out, const char* digits, const int count) {
+    std::memcpy(out, digits, count);
+    return out + count;
+}
+
+char* AppendZeros(char* out, const int count) {
+    std::memset(out, '0', count);
+    return out + count;
+}
+
+// Writes digits * 10^exponent.
+char* WriteDecimal(const char* digits, const int length, const int exponent, char* out) {
+    // Position of the decimal point relative to the first digit.
+    const int point = length + exponent;
+    if (exponent >= 0 && point <= kMaxFixedDigits) {
+        // 1234000
+        return AppendZeros(AppendDigits(out, digits, length), exponent);
+    }
+    if (point > 0 && point <= kMaxFixedDigits) {
+        // 12.34
+        out = AppendDigits(out, digits, point);
+        *out++ = '.';
+        return AppendDigits(out, digits + point, length - point);
+    }
+    if (point > -4 && point <= 0) {
+        // 0.001234
+        out = AppendZeros(Append(out, "0."), -point);
+        return AppendDigits(out, digits, length);
+    }
+    // 1.234e-07
+    *out++ = digits[0];
+    if (length > 1) {
+        *out++ = '.';
+        out = AppendDigits(out, digits + 1, length - 1);
+    }
+    int power = point - 1;
+    *out++ = 'e';
+    *out++ = power < 0 ? '-' : '+';
+    power = std::abs(power);
+    if (power >= 100) {
+        *out++ = static_cast<char>('0' + power / 100);
+        power %= 100;
+    }
+    *out++ = static_cast<char>('0' + power / 10);
+    *out++ = static_cast<char>('0' + power % 10);
+    return out;
+}
+
+template <class T>
+char* FormatFloating(T value, char* out) {
+    if (std::isnan(value)) {
+        return Append(out, "nan");
+    }
+    if (std::signbit(value)) {
+        *out++ = '-';
+        value = -value;
+    }
+    if (std::isinf(value)) {
+        return Append(out, "inf");
+    }
+    if (value == T(0)) {
+        *out++ = '0';
+        return out;
+    }
+    char digits[32];
+    int exponent;
+    const int length = ShortestDigits(value, digits, &exponent);
+    return WriteDecimal(digits, length, exponent, out);
+}
+
+// Parsing ------------------------------------------------------------------------------------
+
+// Largest integer and power of ten that are exact in each type. Their product or quotient is
+// a single correctly rounded operation (Clinger's fast path).
+template <class T>
+struct FastPath;
+
+template <>
+struct FastPath<double> {
+    static constexpr uint64_t kMaxMantissa{uint64_t{1} << 53};
+    static constexpr int kMaxExponent{22};
+};
+
+template <>
+struct FastPath<float> {
+    static constexpr uint64_t kMaxMantissa{uint64_t{1} << 24};
+    static constexpr int kMaxExponent{10};
+};
+
+constexpr double kPowersOfTen[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                                   1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+// Significant digits that fit in a uint64_t.
+constexpr int kMaxMantissaDigits{19};
+
+bool IsDigit(const char c) {
+    return c >= '0' && c <= '9';
+}
+
+const char* SkipBlanks(const char* p, const char* end) {
+    while (p != end && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r')) {
+        ++p;
+    }
+    return p;
+}
+
+// Matches |literal|, allowing blanks before each of its characters. Returns nullptr if the
+// text does not match.
+template <size_t N>
+const char* Expect(const char* p, const char* end, const char (&literal)[N]) {
+    for (size_t i = 0; i + 1 < N; ++i) {
+        p = SkipBlanks(p, end);
+        if (p == end || *p != literal[i]) {
+            return nullptr;
+        }
+        ++p;
+    }
+    return p;
+}
+
+// The "C" locale, so the slow path does not depend on the process locale.
+locale_t CLocale() {
+    static const locale_t locale = newlocale(LC_ALL_MASK, "C", nullptr);
+    return locale;
+}
+
+double StringTo(const char* text, double*) {
+    return strtod_l(text, nullptr, CLocale());
+}
+
+float StringTo(const char* text, float*) {
+    return strtof_l(text, nullptr, CLocale());
+}
+
+// Correctly rounded conversion of the number in [begin, end) through the C library, for the
+// cases the fast path cannot handle exactly.
+template <class T>
+T SlowParse(const char* begin, const char* end) {
+    const size_t length = static_cast<size_t>(end - begin);
+    char text[64];
+    if (length < sizeof(text)) {
+        std::memcpy(text, begin, length);
+        text[length] = '\0';
+        return StringTo(text, static_cast<T*>(nullptr));
+    }
+    const std::string copy(begin, end);
+    return StringTo(copy.c_str(), static_cast<T*>(nullptr));
+}
+
+template <class T>
+const char* ParseFloating(const char* begin, const char* end, T* value) {
+    const char* p = SkipBlanks(begin, end);
+    const char* const start = p;
+    bool negative = false;
+    if (p != end && (*p == '-' || *p == '+')) {
+        negative = *p == '-';
+        ++p;
+    }
+    if (end - p >= 3 && std::memcmp(p, "inf", 3) == 0) {
+        *value = negative ? -std::numeric_limits<T>::infinity() : std::numeric_limits<T>::infinity();
+        return p + 3;
+    }
+    if (end - p >= 3 && std::memcmp(p, "nan", 3) == 0) {
+        *value = std::numeric_limits<T>::quiet_NaN();
+        return p + 3;
+    }
+
+    // value = mantissa * 10^exponent, with the digits past the 19th dropped.
+    uint64_t mantissa = 0;
+    int digits = 0;
+    int exponent = 0;
+    bool any_digit = false;
+    bool truncated = false;
+    for (; p != end && IsDigit(*p); ++p) {
+        any_digit = true;
+        if (digits < kMaxMantissaDigits) {
+            mantissa = mantissa * 10 + static_cast<uint64_t>(*p - '0');
+            digits += mantissa != 0;
+        } else {
+            ++exponent;
+            truncated |= *p != '0';
+        }
+    }
+    if (p != end && *p == '.') {
+        for (++p; p != end && IsDigit(*p); ++p) {
+            any_digit = true;
+            if (digits < kMaxMantissaDigits) {
+                mantissa = mantissa * 10 + static_cast<uint64_t>(*p - '0');
+                digits += mantissa != 0;
+                --exponent;
+            } else {
+                truncated |= *p != '0';
+            }
+        }
+    }
+    if (!any_digit) {
+        return nullptr;
+    }
+    if (p != end && (*p == 'e' || *p == 'E')) {
+        const char* q = p + 1;
+        bool negative_power = false;
+        if (q != end && (*q == '-' || *q == '+')) {
+            negative_power = *q == '-';
+            ++q;
+        }
+        // Without digits the 'e' is not part of the number.
+        if (q != end && IsDigit(*q)) {
+            int power = 0;
+            for (; q != end && IsDigit(*q); ++q) {
+                // Saturates well past the range of any floating point type.
+                power = std::min(power * 10 + (*q - '0'), 100000);
+            }
+            exponent += negative_power ? -power : power;
+            p = q;
+        }
+    }
+
+    if (mantissa == 0) {
+        *value = negative ? -T(0) : T(0);
+    } else if (!truncated && mantissa <= FastPath<T>::kMaxMantissa && exponent >= -FastPath<T>::kMaxExponent &&
+               exponent <= FastPath<T>::kMaxExponent) {
+        const T magnitude = exponent < 0 ? static_cast<T>(mantissa) / static_cast<T>(kPowersOfTen[-exponent])
+                                         : static_cast<T>(mantissa) * static_cast<T>(kPowersOfTen[exponent]);
+        *value = negative ? -magnitude : magnitude;
+    } else {
+        *value = SlowParse<T>(start, p);
+    }
+    return p;
+}
+
+}  // namespace
+
+char* FormatScalar(double value, char* buffer) {
+    return FormatFloating(value, buffer);
+}
+
+char* FormatScalar(float value, char* buffer) {
+    return FormatFloating(value, buffer);
+}
+
+const char* ParseScalar(const char* begin, const char* end, double* value) {
+    return ParseFloating(begin, end, value);
+}
+
+const char* ParseScalar(const char* begin, const char* end, float* value) {
+    return ParseFloating(begin, end, value);
+}
+
+template <class T>
+char* Format(const Vector3T<T>& vector, char* buffer) {
+    buffer = FormatScalar(vector.x(), Append(buffer, "(x: "));
+    buffer = FormatScalar(vector.y(), Append(buffer, ", y: "));
+    buffer = FormatScalar(vector.z(), Append(buffer, ", z: "));
+    return Append(buffer, ")");
+}
+
+template <class T>
+char* Format(const Matrix3T<T>& matrix, char* buffer) {
+    buffer = Append(buffer, "[[");
+    for (uint32_t row = 0; row < 3; ++row) {
+        if (row != 0) {
+            buffer = Append(buffer, "], [");
+        }
+        buffer = FormatScalar(matrix[row][0], buffer);
+        buffer = FormatScalar(matrix[row][1], Append(buffer, ", "));
+        buffer = FormatScalar(matrix[row][2], Append(buffer, ", "));
+    }
+    return Append(buffer, "]]");
+}
+
+template <class T>
+char* Format(const IsometryT<T>& isometry, char* buffer) {
+    buffer = Format(isometry.translation(), Append(buffer, "[T: "));
+    buffer = Format(isometry.rotation(), Append(buffer, ", R:"));
+    return Append(buffer, "]");
+}
+
+template <class T>
+const char* Parse(const char* begin, const char* end, Vector3T<T>* vector) {
+    Vector3T<T> result;
+    const char* p = Expect(begin, end, "(x:");
+    p = p == nullptr ? nullptr : ParseScalar(p, end, &result.x());
+    p = p == nullptr ? nullptr : Expect(p, end, ",y:");
+    p = p == nullptr ? nullptr : ParseScalar(p, end, &result.y());
+    p = p == nullptr ? nullptr : Expect(p, end, ",z:");
+    p = p == nullptr ? nullptr : ParseScalar(p, end, &result.z());
+    p = p == nullptr ? nullptr : Expect(p, end, ")");
+    if (p != nullptr) {
+        *vector = result;
+    }
+    return p;
+}
+
+template <class T>
+const char* Parse(const char* begin, const char* end, Matrix3T<T>* matrix) {
+    Matrix3T<T> result;
+    const char* p = Expect(begin, end, "[[");
+    for (uint32_t row = 0; row < 3 && p != nullptr; ++row) {
+        if (row != 0) {
+            p = Expect(p, end, "],[");
+        }
+        for (int column = 0; column < 3 && p != nullptr; ++column) {
+            if (column != 0) {
+                p = Expect(p, end, ",");
+            }
+            p = p == nullptr ? nullptr : ParseScalar(p, end, &result[row][column]);
+        }
+    }
+    p = p == nullptr ? nullptr : Expect(p, end, "]]");
+    if (p != nullptr) {
+        *matrix = result;
+    }
+    return p;
+}
+
+template <class T>
+const char* Parse(const char* begin, const char* end, IsometryT<T>* isometry) {
+    Vector3T<T> translation;
+    Matrix3T<T> rotation;
+    const char* p = Expect(begin, end, "[T:");
+    p = p == nullptr ? nullptr : Parse(p, end, &translation);
+    p = p == nullptr ? nullptr : Expect(p, end, ",R:");
+    p = p == nullptr ? nullptr : Parse(p, end, &rotation);
+    p = p == nullptr ? nullptr : Expect(p, end, "]");
+    if (p == nullptr || !rotation.isOrthonormal(IsometryT<T>::kOrthonormalTolerance)) {
+        return nullptr;
+    }
+    *isometry = IsometryT<T>(translation, rotation);
+    return p;
+}
+
+// Supported scalar types.
+template char* Format(const Vector3T<double>& vector, char* buffer);
+template char* Format(const Vector3T<float>& vector, char* buffer);
+template char* Format(const Matrix3T<double>& matrix, char* buffer);
+template char* Format(const Matrix3T<float>& matrix, char* buffer);
+template char* Format(const IsometryT<double>& isometry, char* buffer);
+template char* Format(const IsometryT<float>& isometry, char* buffer);
+template const char* Parse(const char* begin, const char* end, Vector3T<double>* vector);
+template const char* Parse(const char* begin, const char* end, Vector3T<float>* vector);
+template const char* Parse(const char* begin, const char* end, Matrix3T<double>* matrix);
+template const char* Parse(const char* begin, const char* end, Matrix3T<float>* matrix);
+template const char* Parse(const char* begin, const char* end, IsometryT<double>* isometry);
+template const char* Parse(const char* begin, const char* end, IsometryT<float>* isometry);
+
+}  // namespace math
+}  // namespace ekumen
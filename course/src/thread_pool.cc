@@ -0,0 +1,129 @@
+#include "thread_pool.h"
+
+#include <algorithm>
+
+namespace ekumen {
+namespace math {
+
+ThreadPool::ThreadPool(size_t threads) {
+    if (threads == 0) {
+        threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+    for (size_t i = 0; i < threads; ++i) {
+        queues_.emplace_back(new Queue);
+    }
+    for (size_t i = 0; i < threads; ++i) {
+        workers_.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(idle_mutex_);
+        stopping_ = true;
+    }
+    idle_.notify_all();
+    for (std::thread& worker : workers_) {
+        worker.join();
+    }
+}
+
+void ThreadPool::parallelFor(size_t count, const std::function<void(size_t)>& task) {
+    if (count == 0) {
+        return;
+    }
+    Group group;
+    group.remaining.store(count, std::memory_order_relaxed);
+    // Deal contiguous ranges to the queues, so neighbouring indices start on the same worker.
+    const size_t per_queue = (count + queues_.size() - 1) / queues_.size();
+    for (size_t begin = 0, queue = 0; begin < count; begin += per_queue, ++queue) {
+        const size_t end = std::min(count, begin + per_queue);
+        std::lock_guard<std::mutex> lock(queues_[queue]->mutex);
+        for (size_t i = begin; i < end; ++i) {
+            queues_[queue]->tasks.push_back(Task{[&task, i]() { task(i); }, &group});
+        }
+    }
+    queued_.fetch_add(count, std::memory_order_release);
+    {
+        std::lock_guard<std::mutex> lock(idle_mutex_);
+    }
+    idle_.notify_all();
+
+    // Help out instead of blocking, which also keeps nested calls from deadlocking.
+    Task next;
+    while (group.remaining.load(std::memory_order_acquire) != 0) {
+        if (takeTask(0, &next)) {
+            runTask(next);
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(group.mutex);
+        group.finished.wait(lock, [&group]() { return group.remaining.load(std::memory_order_acquire) == 0; });
+    }
+    // The last task signals under the group mutex. Taking it here waits until that task no
+    // longer touches |group| before it goes out of scope.
+    std::lock_guard<std::mutex> lock(group.mutex);
+    if (group.error) {
+        std::rethrow_exception(group.error);
+    }
+}
+
+void ThreadPool::workerLoop(size_t index) {
+    Task task;
+    while (true) {
+        if (takeTask(index, &task)) {
+            runTask(task);
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(idle_mutex_);
+        idle_.wait(lock, [this]() { return stopping_ || queued_.load(std::memory_order_acquire) != 0; });
+        if (stopping_ && queued_.load(std::memory_order_acquire) == 0) {
+            return;
+        }
+    }
+}
+
+bool ThreadPool::takeTask(size_t index, Task* task) {
+    // Own queue from the back, where the most recently queued and cache-warm tasks are.
+    {
+        Queue& own = *queues_[index];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            *task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            queued_.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    // Steal the oldest task of the other queues.
+    for (size_t offset = 1; offset < queues_.size(); ++offset) {
+        Queue& victim = *queues_[(index + offset) % queues_.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            *task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            queued_.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::runTask(Task& task) {
+    Group& group = *task.group;
+    try {
+        task.run();
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(group.mutex);
+        if (!group.error) {
+            group.error = std::current_exception();
+        }
+    }
+    task.run = nullptr;
+    std::lock_guard<std::mutex> lock(group.mutex);
+    if (group.remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        group.finished.notify_all();
+    }
+}
+
+}  // namespace math
+}  // namespace ekumen
@@ -0,0 +1,66 @@
+#include "trajectory.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace ekumen {
+namespace math {
+namespace {
+
+// Blocks per worker. More than one lets fast workers steal from slow ones.
+constexpr size_t kBlocksPerWorker{4};
+
+// Scans steps [begin, end) onto |start|.
+void ScanBlock(const Isometry& start, const Isometry* steps, Isometry* poses, size_t begin, size_t end) {
+    Isometry pose = start;
+    for (size_t i = begin; i < end; ++i) {
+        pose = pose * steps[i];
+        poses[i] = pose;
+    }
+}
+
+}  // namespace
+
+void PrefixCompose(const Isometry* steps, Isometry* poses, size_t count) {
+    if (count == 0) {
+        return;
+    }
+    poses[0] = steps[0];
+    ScanBlock(steps[0], steps, poses, 1, count);
+}
+
+void PrefixCompose(ThreadPool& pool, const Isometry* steps, Isometry* poses, size_t count,
+                   size_t min_parallel_count) {
+    if (count < std::max<size_t>(min_parallel_count, 2) || pool.size() < 2) {
+        PrefixCompose(steps, poses, count);
+        return;
+    }
+    const size_t block_size = (count + pool.size() * kBlocksPerWorker - 1) / (pool.size() * kBlocksPerWorker);
+    // Rounding the size up may leave fewer, but never empty, blocks.
+    const size_t blocks = (count + block_size - 1) / block_size;
+    const Isometry identity = Isometry::FromTranslation(Vector3::kZero);
+
+    // Product of every block but the last one, which nothing depends on.
+    std::vector<Isometry> totals(blocks, identity);
+    pool.parallelFor(blocks - 1, [&](size_t block) {
+        const size_t begin = block * block_size;
+        const size_t end = std::min(count, begin + block_size);
+        Isometry total = steps[begin];
+        for (size_t i = begin + 1; i < end; ++i) {
+            total = total * steps[i];
+        }
+        totals[block] = total;
+    });
+    // totals[b] becomes the pose right before block b + 1.
+    for (size_t block = 1; block + 1 < blocks; ++block) {
+        totals[block] = totals[block - 1] * totals[block];
+    }
+    pool.parallelFor(blocks, [&](size_t block) {
+        const size_t begin = block * block_size;
+        const size_t end = std::min(count, begin + block_size);
+        ScanBlock(block == 0 ? identity : totals[block - 1], steps, poses, begin, end);
+    });
+}
+
+}  // namespace math
+}  // namespace ekumen
@@ -0,0 +1,89 @@
+#include "transform_buffer.h"
+
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+namespace ekumen {
+namespace math {
+
+TransformBuffer::TransformBuffer(size_t capacity, double retention) : retention_(retention) {
+    if (capacity == 0) {
+        throw std::invalid_argument("TransformBuffer capacity must be positive");
+    }
+    if (!(retention >= 0.)) {
+        throw std::invalid_argument("TransformBuffer retention must not be negative");
+    }
+    samples_.resize(capacity);
+}
+
+void TransformBuffer::insert(double stamp, const Isometry& transform) {
+    // Checked up front: on an empty buffer nothing else would catch it, and no later stamp
+    // could ever follow a NaN or infinite one.
+    if (!std::isfinite(stamp)) {
+        throw std::invalid_argument("TransformBuffer stamps must be finite, got " + std::to_string(stamp));
+    }
+    if (size_ != 0 && !(stamp > newest())) {
+        throw std::invalid_argument("TransformBuffer stamps must be strictly increasing, got " +
+                                    std::to_string(stamp) + " after " + std::to_string(newest()));
+    }
+    if (size_ == samples_.size()) {
+        dropOldest();
+    }
+    Sample& sample = samples_[(head_ + size_) % samples_.size()];
+    sample.stamp = stamp;
+    sample.transform = QuaternionIsometry(transform);
+    ++size_;
+    while (at(0).stamp < stamp - retention_) {
+        dropOldest();
+    }
+}
+
+QuaternionIsometry TransformBuffer::lookupQuaternion(double stamp) const {
+    if (empty() || !(stamp >= oldest() && stamp <= newest())) {
+        throw std::out_of_range("TransformBuffer has no data at " + std::to_string(stamp));
+    }
+    // Binary search for the first sample at or after |stamp|.
+    size_t first = 0;
+    size_t count = size_;
+    while (count > 0) {
+        const size_t step = count / 2;
+        if (at(first + step).stamp < stamp) {
+            first += step + 1;
+            count -= step + 1;
+        } else {
+            count = step;
+        }
+    }
+    const Sample& after = at(first);
+    if (after.stamp == stamp) {
+        return after.transform;
+    }
+    const Sample& before = at(first - 1);
+    const double t = (stamp - before.stamp) / (after.stamp - before.stamp);
+    const Vector3& from = before.transform.translation();
+    const Vector3& to = after.transform.translation();
+    return QuaternionIsometry(from + (to - from) * t,
+                              Quaternion::Slerp(before.transform.rotation(), after.transform.rotation(), t));
+}
+
+Isometry TransformBuffer::lookup(double stamp) const {
+    return lookupQuaternion(stamp).toIsometry();
+}
+
+double TransformBuffer::oldest() const {
+    if (empty()) {
+        throw std::out_of_range("TransformBuffer is empty");
+    }
+    return at(0).stamp;
+}
+
+double TransformBuffer::newest() const {
+    if (empty()) {
+        throw std::out_of_range("TransformBuffer is empty");
+    }
+    return at(size_ - 1).stamp;
+}
+
+}  // namespace math
+}  // namespace ekumen
@@ -0,0 +1,293 @@
+#include "transform_kernels.h"
+
+#include <stdexcept>
+#include <string>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define EKUMEN_MATH_X86 1
+#include <immintrin.h>
+#elif defined(__aarch64__)
+#define EKUMEN_MATH_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace ekumen {
+namespace math {
+namespace {
+
+// Handles points [|begin|, |count|). Shared by every kernel for its tail.
+template <class T>
+void TransformScalar(const T rotation[9], const T translation[3], const T* x, const T* y, const T* z, T* out_x,
+                     T* out_y, T* out_z, size_t begin, size_t count) {
+    for (size_t i = begin; i < count; ++i) {
+        const T px = x[i];
+        const T py = y[i];
+        const T pz = z[i];
+        out_x[i] = rotation[0] * px + rotation[1] * py + rotation[2] * pz + translation[0];
+        out_y[i] = rotation[3] * px + rotation[4] * py + rotation[5] * pz + translation[1];
+        out_z[i] = rotation[6] * px + rotation[7] * py + rotation[8] * pz + translation[2];
+    }
+}
+
+#if defined(EKUMEN_MATH_X86)
+
+__attribute__((target("sse4.2")))
+void TransformSse42(const double rotation[9], const double translation[3], const double* x, const double* y,
+                    const double* z, double* out_x, double* out_y, double* out_z, size_t count) {
+    const __m128d r0 = _mm_set1_pd(rotation[0]), r1 = _mm_set1_pd(rotation[1]), r2 = _mm_set1_pd(rotation[2]);
+    const __m128d r3 = _mm_set1_pd(rotation[3]), r4 = _mm_set1_pd(rotation[4]), r5 = _mm_set1_pd(rotation[5]);
+    const __m128d r6 = _mm_set1_pd(rotation[6]), r7 = _mm_set1_pd(rotation[7]), r8 = _mm_set1_pd(rotation[8]);
+    const __m128d tx = _mm_set1_pd(translation[0]);
+    const __m128d ty = _mm_set1_pd(translation[1]);
+    const __m128d tz = _mm_set1_pd(translation[2]);
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2) {
+        const __m128d px = _mm_loadu_pd(x + i);
+        const __m128d py = _mm_loadu_pd(y + i);
+        const __m128d pz = _mm_loadu_pd(z + i);
+        const __m128d qx = _mm_add_pd(
+            _mm_add_pd(_mm_add_pd(_mm_mul_pd(r0, px), _mm_mul_pd(r1, py)), _mm_mul_pd(r2, pz)), tx);
+        const __m128d qy = _mm_add_pd(
+            _mm_add_pd(_mm_add_pd(_mm_mul_pd(r3, px), _mm_mul_pd(r4, py)), _mm_mul_pd(r5, pz)), ty);
+        const __m128d qz = _mm_add_pd(
+            _mm_add_pd(_mm_add_pd(_mm_mul_pd(r6, px), _mm_mul_pd(r7, py)), _mm_mul_pd(r8, pz)), tz);
+        _mm_storeu_pd(out_x + i, qx);
+        _mm_storeu_pd(out_y + i, qy);
+        _mm_storeu_pd(out_z + i, qz);
+    }
+    TransformScalar(rotation, translation, x, y, z, out_x, out_y, out_z, i, count);
+}
+
+__attribute__((target("sse4.2")))
+void TransformSse42(const float rotation[9], const float translation[3], const float* x, const float* y,
+                    const float* z, float* out_x, float* out_y, float* out_z, size_t count) {
+    const __m128 r0 = _mm_set1_ps(rotation[0]), r1 = _mm_set1_ps(rotation[1]), r2 = _mm_set1_ps(rotation[2]);
+    const __m128 r3 = _mm_set1_ps(rotation[3]), r4 = _mm_set1_ps(rotation[4]), r5 = _mm_set1_ps(rotation[5]);
+    const __m128 r6 = _mm_set1_ps(rotation[6]), r7 = _mm_set1_ps(rotation[7]), r8 = _mm_set1_ps(rotation[8]);
+    const __m128 tx = _mm_set1_ps(translation[0]);
+    const __m128 ty = _mm_set1_ps(translation[1]);
+    const __m128 tz = _mm_set1_ps(translation[2]);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m128 px = _mm_loadu_ps(x + i);
+        const __m128 py = _mm_loadu_ps(y + i);
+        const __m128 pz = _mm_loadu_ps(z + i);
+        const __m128 qx = _mm_add_ps(
+            _mm_add_ps(_mm_add_ps(_mm_mul_ps(r0, px), _mm_mul_ps(r1, py)), _mm_mul_ps(r2, pz)), tx);
+        const __m128 qy = _mm_add_ps(
+            _mm_add_ps(_mm_add_ps(_mm_mul_ps(r3, px), _mm_mul_ps(r4, py)), _mm_mul_ps(r5, pz)), ty);
+        const __m128 qz = _mm_add_ps(
+            _mm_add_ps(_mm_add_ps(_mm_mul_ps(r6, px), _mm_mul_ps(r7, py)), _mm_mul_ps(r8, pz)), tz);
+        _mm_storeu_ps(out_x + i, qx);
+        _mm_storeu_ps(out_y + i, qy);
+        _mm_storeu_ps(out_z + i, qz);
+    }
+    TransformScalar(rotation, translation, x, y, z, out_x, out_y, out_z, i, count);
+}
+
+__attribute__((target("avx2")))
+void TransformAvx2(const double rotation[9], const double translation[3], const double* x, const double* y,
+                   const double* z, double* out_x, double* out_y, double* out_z, size_t count) {
+    const __m256d r0 = _mm256_set1_pd(rotation[0]), r1 = _mm256_set1_pd(rotation[1]);
+    const __m256d r2 = _mm256_set1_pd(rotation[2]), r3 = _mm256_set1_pd(rotation[3]);
+    const __m256d r4 = _mm256_set1_pd(rotation[4]), r5 = _mm256_set1_pd(rotation[5]);
+    const __m256d r6 = _mm256_set1_pd(rotation[6]), r7 = _mm256_set1_pd(rotation[7]);
+    const __m256d r8 = _mm256_set1_pd(rotation[8]);
+    const __m256d tx = _mm256_set1_pd(translation[0]);
+    const __m256d ty = _mm256_set1_pd(translation[1]);
+    const __m256d tz = _mm256_set1_pd(translation[2]);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m256d px = _mm256_loadu_pd(x + i);
+        const __m256d py = _mm256_loadu_pd(y + i);
+        const __m256d pz = _mm256_loadu_pd(z + i);
+        const __m256d qx = _mm256_add_pd(
+            _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(r0, px), _mm256_mul_pd(r1, py)), _mm256_mul_pd(r2, pz)), tx);
+        const __m256d qy = _mm256_add_pd(
+            _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(r3, px), _mm256_mul_pd(r4, py)), _mm256_mul_pd(r5, pz)), ty);
+        const __m256d qz = _mm256_add_pd(
+            _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(r6, px), _mm256_mul_pd(r7, py)), _mm256_mul_pd(r8, pz)), tz);
+        _mm256_storeu_pd(out_x + i, qx);
+        _mm256_storeu_pd(out_y + i, qy);
+        _mm256_storeu_pd(out_z + i, qz);
+    }
+    TransformScalar(rotation, translation, x, y, z, out_x, out_y, out_z, i, count);
+}
+
+__attribute__((target("avx2")))
+void TransformAvx2(const float rotation[9], const float translation[3], const float* x, const float* y,
+                   const float* z, float* out_x, float* out_y, float* out_z, size_t count) {
+    const __m256 r0 = _mm256_set1_ps(rotation[0]), r1 = _mm256_set1_ps(rotation[1]);
+    const __m256 r2 = _mm256_set1_ps(rotation[2]), r3 = _mm256_set1_ps(rotation[3]);
+    const __m256 r4 = _mm256_set1_ps(rotation[4]), r5 = _mm256_set1_ps(rotation[5]);
+    const __m256 r6 = _mm256_set1_ps(rotation[6]), r7 = _mm256_set1_ps(rotation[7]);
+    const __m256 r8 = _mm256_set1_ps(rotation[8]);
+    const __m256 tx = _mm256_set1_ps(translation[0]);
+    const __m256 ty = _mm256_set1_ps(translation[1]);
+    const __m256 tz = _mm256_set1_ps(translation[2]);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m256 px = _mm256_loadu_ps(x + i);
+        const __m256 py = _mm256_loadu_ps(y + i);
+        const __m256 pz = _mm256_loadu_ps(z + i);
+        const __m256 qx = _mm256_add_ps(
+            _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(r0, px), _mm256_mul_ps(r1, py)), _mm256_mul_ps(r2, pz)), tx);
+        const __m256 qy = _mm256_add_ps(
+            _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(r3, px), _mm256_mul_ps(r4, py)), _mm256_mul_ps(r5, pz)), ty);
+        const __m256 qz = _mm256_add_ps(
+            _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(r6, px), _mm256_mul_ps(r7, py)), _mm256_mul_ps(r8, pz)), tz);
+        _mm256_storeu_ps(out_x + i, qx);
+        _mm256_storeu_ps(out_y + i, qy);
+        _mm256_storeu_ps(out_z + i, qz);
+    }
+    TransformScalar(rotation, translation, x, y, z, out_x, out_y, out_z, i, count);
+}
+
+#elif defined(EKUMEN_MATH_NEON)
+
+void TransformNeon(const double rotation[9], const double translation[3], const double* x, const double* y,
+                   const double* z, double* out_x, double* out_y, double* out_z, size_t count) {
+    const float64x2_t r0 = vdupq_n_f64(rotation[0]), r1 = vdupq_n_f64(rotation[1]), r2 = vdupq_n_f64(rotation[2]);
+    const float64x2_t r3 = vdupq_n_f64(rotation[3]), r4 = vdupq_n_f64(rotation[4]), r5 = vdupq_n_f64(rotation[5]);
+    const float64x2_t r6 = vdupq_n_f64(rotation[6]), r7 = vdupq_n_f64(rotation[7]), r8 = vdupq_n_f64(rotation[8]);
+    const float64x2_t tx = vdupq_n_f64(translation[0]);
+    const float64x2_t ty = vdupq_n_f64(translation[1]);
+    const float64x2_t tz = vdupq_n_f64(translation[2]);
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2) {
+        const float64x2_t px = vld1q_f64(x + i);
+        const float64x2_t py = vld1q_f64(y + i);
+        const float64x2_t pz = vld1q_f64(z + i);
+        // vmulq/vaddq rather than vfmaq to stay bit-exact with the scalar kernel.
+        const float64x2_t qx = vaddq_f64(vaddq_f64(vaddq_f64(vmulq_f64(r0, px), vmulq_f64(r1, py)), vmulq_f64(r2, pz)), tx);
+        const float64x2_t qy = vaddq_f64(vaddq_f64(vaddq_f64(vmulq_f64(r3, px), vmulq_f64(r4, py)), vmulq_f64(r5, pz)), ty);
+        const float64x2_t qz = vaddq_f64(vaddq_f64(vaddq_f64(vmulq_f64(r6, px), vmulq_f64(r7, py)), vmulq_f64(r8, pz)), tz);
+        vst1q_f64(out_x + i, qx);
+        vst1q_f64(out_y + i, qy);
+        vst1q_f64(out_z + i, qz);
+    }
+    TransformScalar(rotation, translation, x, y, z, out_x, out_y, out_z, i, count);
+}
+
+void TransformNeon(const float rotation[9], const float translation[3], const float* x, const float* y,
+                   const float* z, float* out_x, float* out_y, float* out_z, size_t count) {
+    const float32x4_t r0 = vdupq_n_f32(rotation[0]), r1 = vdupq_n_f32(rotation[1]), r2 = vdupq_n_f32(rotation[2]);
+    const float32x4_t r3 = vdupq_n_f32(rotation[3]), r4 = vdupq_n_f32(rotation[4]), r5 = vdupq_n_f32(rotation[5]);
+    const float32x4_t r6 = vdupq_n_f32(rotation[6]), r7 = vdupq_n_f32(rotation[7]), r8 = vdupq_n_f32(rotation[8]);
+    const float32x4_t tx = vdupq_n_f32(translation[0]);
+    const float32x4_t ty = vdupq_n_f32(translation[1]);
+    const float32x4_t tz = vdupq_n_f32(translation[2]);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const float32x4_t px = vld1q_f32(x + i);
+        const float32x4_t py = vld1q_f32(y + i);
+        const float32x4_t pz = vld1q_f32(z + i);
+        const float32x4_t qx = vaddq_f32(vaddq_f32(vaddq_f32(vmulq_f32(r0, px), vmulq_f32(r1, py)), vmulq_f32(r2, pz)), tx);
+        const float32x4_t qy = vaddq_f32(vaddq_f32(vaddq_f32(vmulq_f32(r3, px), vmulq_f32(r4, py)), vmulq_f32(r5, pz)), ty);
+        const float32x4_t qz = vaddq_f32(vaddq_f32(vaddq_f32(vmulq_f32(r6, px), vmulq_f32(r7, py)), vmulq_f32(r8, pz)), tz);
+        vst1q_f32(out_x + i, qx);
+        vst1q_f32(out_y + i, qy);
+        vst1q_f32(out_z + i, qz);
+    }
+    TransformScalar(rotation, translation, x, y, z, out_x, out_y, out_z, i, count);
+}
+
+#endif
+
+SimdLevel DetectSimdLevelUncached() {
+#if defined(EKUMEN_MATH_X86)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return SimdLevel::kAvx2;
+    }
+    if (__builtin_cpu_supports("sse4.2")) {
+        return SimdLevel::kSse42;
+    }
+#elif defined(EKUMEN_MATH_NEON)
+    return SimdLevel::kNeon;
+#endif
+    return SimdLevel::kScalar;
+}
+
+template <class T>
+void Dispatch(SimdLevel level, const T rotation[9], const T translation[3], const T* x, const T* y, const T* z,
+              T* out_x, T* out_y, T* out_z, size_t count) {
+    if (!IsSupported(level)) {
+        throw std::invalid_argument(std::string("SIMD level not supported by this CPU: ") + ToString(level));
+    }
+    switch (level) {
+#if defined(EKUMEN_MATH_X86)
+        case SimdLevel::kAvx2:
+            TransformAvx2(rotation, translation, x, y, z, out_x, out_y, out_z, count);
+            return;
+        case SimdLevel::kSse42:
+            TransformSse42(rotation, translation, x, y, z, out_x, out_y, out_z, count);
+            return;
+#elif defined(EKUMEN_MATH_NEON)
+        case SimdLevel::kNeon:
+            TransformNeon(rotation, translation, x, y, z, out_x, out_y, out_z, count);
+            return;
+#endif
+        default:
+            TransformScalar(rotation, translation, x, y, z, out_x, out_y, out_z, 0, count);
+            return;
+    }
+}
+
+}  // namespace
+
+const char* ToString(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::kScalar:
+            return "scalar";
+        case SimdLevel::kSse42:
+            return "sse4.2";
+        case SimdLevel::kAvx2:
+            return "avx2";
+        case SimdLevel::kNeon:
+            return "neon";
+    }
+    return "unknown";
+}
+
+bool IsSupported(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::kScalar:
+            return true;
+        case SimdLevel::kSse42:
+            return DetectSimdLevel() == SimdLevel::kSse42 || DetectSimdLevel() == SimdLevel::kAvx2;
+        case SimdLevel::kAvx2:
+            return DetectSimdLevel() == SimdLevel::kAvx2;
+        case SimdLevel::kNeon:
+            return DetectSimdLevel() == SimdLevel::kNeon;
+    }
+    return false;
+}
+
+SimdLevel DetectSimdLevel() {
+    static const SimdLevel level = DetectSimdLevelUncached();
+    return level;
+}
+
+void TransformSoA(SimdLevel level, const double rotation[9], const double translation[3], const double* x,
+                  const double* y, const double* z, double* out_x, double* out_y, double* out_z, size_t count) {
+    Dispatch(level, rotation, translation, x, y, z, out_x, out_y, out_z, count);
+}
+
+void TransformSoA(const double rotation[9], const double translation[3], const double* x, const double* y,
+                  const double* z, double* out_x, double* out_y, double* out_z, size_t count) {
+    Dispatch(DetectSimdLevel(), rotation, translation, x, y, z, out_x, out_y, out_z, count);
+}
+
+void TransformSoA(SimdLevel level, const float rotation[9], const float translation[3], const float* x,
+                  const float* y, const float* z, float* out_x, float* out_y, float* out_z, size_t count) {
+    Dispatch(level, rotation, translation, x, y, z, out_x, out_y, out_z, count);
+}
+
+void TransformSoA(const float rotation[9], const float translation[3], const float* x, const float* y,
+                  const float* z, float* out_x, float* out_y, float* out_z, size_t count) {
+    Dispatch(DetectSimdLevel(), rotation, translation, x, y, z, out_x, out_y, out_z, count);
+}
+
+}  // namespace math
+}  // namespace ekumen
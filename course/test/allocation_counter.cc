@@ -0,0 +1,33 @@
+#include "allocation_counter.h"
+
+#include <cstdlib>
+#include <new>
+
+// Lives apart from the tests: when a replacement operator new is inlined next to its callers,
+// GCC pairs the malloc() inside it with the free() in the replacement operator delete and
+// warns about mismatched allocation functions.
+namespace {
+
+thread_local uint64_t thread_allocations{0};
+
+}  // namespace
+
+void* operator new(std::size_t size) {
+    ++thread_allocations;
+    if (void* pointer = std::malloc(size == 0 ? 1 : size)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept { std::free(pointer); }
+
+void operator delete(void* pointer, std::size_t) noexcept { std::free(pointer); }
+
+namespace ekumen {
+namespace test {
+
+uint64_t ThreadAllocationCount() { return thread_allocations; }
+
+}  // namespace test
+}  // namespace ekumen
@@ -0,0 +1,14 @@
+#pragma once
+
+// Standard libraries
+#include <cstdint>
+
+namespace ekumen {
+namespace test {
+
+// Heap allocations made so far by the calling thread, fed by the global operator new
+// replacement in allocation_counter.cc. Lets tests check that code stays off the allocator.
+uint64_t ThreadAllocationCount();
+
+}  // namespace test
+}  // namespace ekumen
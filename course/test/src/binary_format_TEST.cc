@@ -0,0 +1,242 @@
+#include "binary_format.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace ekumen {
+namespace math {
+namespace test {
+namespace {
+
+std::string TempPath(const std::string& name) {
+  const char* directory = std::getenv("TMPDIR");
+  return std::string(directory != nullptr ? directory : "/tmp") + "/binary_format_TEST_" + name;
+}
+
+// Compares bit patterns, so -0. and NaN payloads have to survive too.
+template <class T>
+bool SameBits(const T a, const T b) {
+  return std::memcmp(&a, &b, sizeof(T)) == 0;
+}
+
+bool SameBits(const Isometry& a, const Isometry& b) {
+  for (uint32_t i = 0; i < 3; ++i) {
+    if (!SameBits(a.translation()[i], b.translation()[i])) {
+      return false;
+    }
+    for (int j = 0; j < 3; ++j) {
+      if (!SameBits(a.rotation()[i][j], b.rotation()[i][j])) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+bool IsAligned(const void* pointer) {
+  return reinterpret_cast<uintptr_t>(pointer) % 64 == 0;
+}
+
+std::vector<Isometry> RandomPoses(const size_t count) {
+  std::mt19937 generator(11);
+  std::uniform_real_distribution<double> value(-1e3, 1e3);
+  std::vector<Isometry> poses;
+  for (size_t i = 0; i < count; ++i) {
+    poses.push_back(Isometry::FromTranslation(Vector3{value(generator), value(generator), value(generator) * 1e-7}) *
+                    Isometry::FromEulerAngles(value(generator), value(generator), value(generator)));
+  }
+  return poses;
+}
+
+void Corrupt(const std::string& path, const size_t offset, const uint8_t byte) {
+  std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+  file.seekp(offset);
+  file.put(static_cast<char>(byte));
+}
+
+GTEST_TEST(BinaryFormatTest, TrajectoryRoundTripIsLossless) {
+  const std::string path = TempPath("trajectory.bin");
+  const std::vector<Isometry> poses = RandomPoses(1001);
+  {
+    TrajectoryWriter writer(path);
+    writer.append(poses[0]);
+    writer.append(poses.data() + 1, poses.size() - 1);
+    EXPECT_EQ(writer.size(), poses.size());
+  }
+  const TrajectoryReader reader(path);
+  ASSERT_EQ(reader.size(), poses.size());
+  EXPECT_TRUE(IsAligned(reader.data()));
+  for (size_t i = 0; i < poses.size(); ++i) {
+    ASSERT_TRUE(SameBits(reader.pose(i), poses[i])) << i;
+  }
+  // Seeking reads one record.
+  EXPECT_TRUE(SameBits(reader.pose(777), poses[777]));
+  EXPECT_EQ(reader.data()[12 * 500 + 9], poses[500].translation().x());
+  EXPECT_THROW(reader.pose(poses.size()), std::out_of_range);
+  std::remove(path.c_str());
+}
+
+GTEST_TEST(BinaryFormatTest, EmptyTrajectory) {
+  const std::string path = TempPath("empty.bin");
+  TrajectoryWriter writer(path);
+  writer.close();
+  EXPECT_THROW(writer.append(RandomPoses(1)[0]), std::logic_error);
+  const TrajectoryReader reader(path);
+  EXPECT_EQ(reader.size(), 0u);
+  EXPECT_THROW(reader.pose(0), std::out_of_range);
+  std::remove(path.c_str());
+}
+
+template <class T>
+void CheckPointCloudRoundTrip(const bool intensity, const bool timestamp) {
+  const std::string path = TempPath("cloud.bin");
+  PointCloudT<T> cloud;
+  if (intensity) {
+    cloud.enableIntensity();
+  }
+  if (timestamp) {
+    cloud.enableTimestamp();
+  }
+  // Values that a text format would round or mangle.
+  const T specials[]{T(0.1), -T(0), std::numeric_limits<T>::denorm_min(), std::numeric_limits<T>::max(),
+                     std::numeric_limits<T>::infinity(), std::numeric_limits<T>::quiet_NaN(), T(1) / T(3)};
+  for (size_t i = 0; i < 37; ++i) {
+    cloud.push_back(Vector3T<T>(specials[i % 7], specials[(i + 1) % 7] * T(i), T(i) + T(0.25)));
+    if (intensity) {
+      cloud.intensity()[i] = 0.1f * i;
+    }
+    if (timestamp) {
+      cloud.timestamp()[i] = 1e9 + 1e-3 * i;
+    }
+  }
+  WritePointCloud(path, cloud);
+
+  const PointCloudReaderT<T> reader(path);
+  ASSERT_EQ(reader.size(), cloud.size());
+  EXPECT_TRUE(IsAligned(reader.x()));
+  EXPECT_TRUE(IsAligned(reader.y()));
+  EXPECT_TRUE(IsAligned(reader.z()));
+  EXPECT_EQ(reader.intensity() != nullptr, intensity);
+  EXPECT_EQ(reader.timestamp() != nullptr, timestamp);
+  const PointCloudT<T> copy = reader.toPointCloud();
+  for (size_t i = 0; i < cloud.size(); ++i) {
+    EXPECT_TRUE(SameBits(reader.x()[i], cloud.x()[i]));
+    EXPECT_TRUE(SameBits(reader.y()[i], cloud.y()[i]));
+    EXPECT_TRUE(SameBits(reader.z()[i], cloud.z()[i]));
+    EXPECT_TRUE(SameBits(copy.y()[i], cloud.y()[i]));
+    if (intensity) {
+      EXPECT_TRUE(IsAligned(reader.intensity()));
+      EXPECT_TRUE(SameBits(reader.intensity()[i], cloud.intensity()[i]));
+      EXPECT_TRUE(SameBits(copy.intensity()[i], cloud.intensity()[i]));
+    }
+    if (timestamp) {
+      EXPECT_TRUE(IsAligned(reader.timestamp()));
+      EXPECT_TRUE(SameBits(reader.timestamp()[i], cloud.timestamp()[i]));
+    }
+  }
+  EXPECT_EQ(copy.hasIntensity(), intensity);
+  EXPECT_EQ(copy.hasTimestamp(), timestamp);
+  std::remove(path.c_str());
+}
+
+GTEST_TEST(BinaryFormatTest, RejectsCorruptedPoses) {
+  const std::string path = TempPath("corrupted_poses.bin");
+  {
+    TrajectoryWriter writer(path);
+    const std::vector<Isometry> poses = RandomPoses(3);
+    writer.append(poses.data(), poses.size());
+  }
+  // A 64 byte header, then 96 byte records of little endian doubles. Setting the top byte of
+  // a rotation word to 0x40 turns it into a value of at least 2.
+  Corrupt(path, 64 + 96 * 1 + 8 * 4 + 7, 0x40);
+  // Exponent all ones with a nonzero mantissa: NaN in a translation word.
+  Corrupt(path, 64 + 96 * 2 + 8 * 10 + 6, 0xff);
+  Corrupt(path, 64 + 96 * 2 + 8 * 10 + 7, 0x7f);
+
+  const TrajectoryReader reader(path);
+  ASSERT_EQ(reader.size(), 3u);
+  EXPECT_NO_THROW(reader.pose(0));
+  EXPECT_THROW(reader.pose(1), std::runtime_error);
+  EXPECT_THROW(reader.pose(2), std::runtime_error);
+  std::remove(path.c_str());
+}
+
+GTEST_TEST(BinaryFormatTest, PointCloudRoundTripIsLossless) {
+  for (const bool intensity : {false, true}) {
+    for (const bool timestamp : {false, true}) {
+      CheckPointCloudRoundTrip<double>(intensity, timestamp);
+      CheckPointCloudRoundTrip<float>(intensity, timestamp);
+    }
+  }
+  const std::string path = TempPath("empty_cloud.bin");
+  WritePointCloud(path, PointCloud());
+  EXPECT_EQ(PointCloudReader(path).size(), 0u);
+  std::remove(path.c_str());
+}
+
+GTEST_TEST(BinaryFormatTest, RejectsInvalidFiles) {
+  EXPECT_THROW(TrajectoryReader(TempPath("missing.bin")), std::runtime_error);
+  EXPECT_THROW(TrajectoryWriter("/nonexistent_directory/trajectory.bin"), std::runtime_error);
+
+  const std::string trajectory = TempPath("invalid_trajectory.bin");
+  {
+    TrajectoryWriter writer(trajectory);
+    const std::vector<Isometry> poses = RandomPoses(4);
+    writer.append(poses.data(), poses.size());
+  }
+  const std::string cloud = TempPath("invalid_cloud.bin");
+  WritePointCloud(cloud, PointCloud(10));
+
+  // Wrong kind and wrong scalar type.
+  EXPECT_THROW(PointCloudReader{trajectory}, std::runtime_error);
+  EXPECT_THROW(TrajectoryReader{cloud}, std::runtime_error);
+  EXPECT_THROW(PointCloudfReader{cloud}, std::runtime_error);
+
+  // Truncated data.
+  {
+    std::ofstream file(TempPath("truncated.bin"), std::ios::binary);
+    std::ifstream source(trajectory, std::ios::binary);
+    std::vector<char> bytes(64 + 96 * 3);
+    source.read(bytes.data(), bytes.size());
+    file.write(bytes.data(), bytes.size());
+  }
+  EXPECT_THROW(TrajectoryReader(TempPath("truncated.bin")), std::runtime_error);
+  {
+    std::ofstream file(TempPath("tiny.bin"), std::ios::binary);
+    file << "EKU";
+  }
+  EXPECT_THROW(TrajectoryReader(TempPath("tiny.bin")), std::runtime_error);
+
+  // Newer format version, then bad magic.
+  Corrupt(trajectory, 8, kBinaryFormatVersion + 1);
+  EXPECT_THROW(TrajectoryReader{trajectory}, std::runtime_error);
+  Corrupt(trajectory, 8, kBinaryFormatVersion);
+  EXPECT_EQ(TrajectoryReader(trajectory).size(), 4u);
+  Corrupt(trajectory, 0, 'X');
+  EXPECT_THROW(TrajectoryReader{trajectory}, std::runtime_error);
+
+  for (const std::string& name : {trajectory, cloud, TempPath("truncated.bin"), TempPath("tiny.bin")}) {
+    std::remove(name.c_str());
+  }
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace math
+}  // namespace ekumen
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
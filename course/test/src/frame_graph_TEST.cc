@@ -0,0 +1,134 @@
+#include "frame_graph.h"
+
+#include <cmath>
+#include <stdexcept>
+
+#include "gtest/gtest.h"
+
+namespace ekumen {
+namespace math {
+namespace test {
+namespace {
+
+constexpr double kTolerance{1e-9};
+
+testing::AssertionResult areAlmostEqual(const Isometry& isometry1, const Isometry& isometry2, const double tolerance) {
+  for (int i = 0; i < 3; ++i) {
+    if (std::abs(isometry1.translation()[i] - isometry2.translation()[i]) > tolerance) {
+      return testing::AssertionFailure() << "Translations differ: " << isometry1 << " vs " << isometry2;
+    }
+    for (int j = 0; j < 3; ++j) {
+      if (std::abs(isometry1.rotation()[i][j] - isometry2.rotation()[i][j]) > tolerance) {
+        return testing::AssertionFailure() << "Rotations differ: " << isometry1 << " vs " << isometry2;
+      }
+    }
+  }
+  return testing::AssertionSuccess();
+}
+
+Isometry Pose(const double x, const double y, const double z, const double yaw) {
+  return Isometry::FromTranslation(Vector3{x, y, z}) * Isometry::RotateAround(Vector3::kUnitZ, yaw);
+}
+
+// world -> map -> odom -> base -> {lidar, camera}
+class FrameGraphTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    graph_.addFrame("world");
+    graph_.addFrame("map", "world", world_to_map_);
+    graph_.addFrame("odom", "map", map_to_odom_);
+    graph_.addFrame("base", "odom", odom_to_base_);
+    graph_.addFrame("lidar", "base", base_to_lidar_);
+    graph_.addFrame("camera", "base", base_to_camera_);
+  }
+
+  FrameGraph graph_;
+  const Isometry world_to_map_{Pose(10., -5., 0., M_PI / 2.)};
+  const Isometry map_to_odom_{Pose(0.5, 0.25, 0., -0.1)};
+  Isometry odom_to_base_{Pose(3., 4., 0., 0.3)};
+  const Isometry base_to_lidar_{Pose(0.2, 0., 1.1, M_PI)};
+  const Isometry base_to_camera_{Pose(0.4, 0.1, 0.8, -M_PI / 4.)};
+};
+
+TEST_F(FrameGraphTest, ComposesAlongTheTree) {
+  EXPECT_EQ(graph_.size(), 6u);
+  EXPECT_EQ(graph_.parent("base"), "odom");
+  EXPECT_EQ(graph_.parent("world"), "");
+
+  const Isometry world_to_base = world_to_map_ * map_to_odom_ * odom_to_base_;
+  EXPECT_TRUE(areAlmostEqual(graph_.transform("base", "world"), world_to_base, kTolerance));
+  EXPECT_TRUE(areAlmostEqual(graph_.transform("world", "base"), world_to_base.inverse(), kTolerance));
+  // Siblings go through their common ancestor.
+  EXPECT_TRUE(areAlmostEqual(graph_.transform("lidar", "camera"), base_to_camera_.inverse() * base_to_lidar_,
+                             kTolerance));
+  EXPECT_TRUE(areAlmostEqual(graph_.transform("odom", "odom"), Isometry::FromTranslation(Vector3::kZero),
+                             kTolerance));
+
+  // Mapping a point through the graph matches mapping it edge by edge.
+  const Vector3 in_lidar{1., 2., 3.};
+  const Vector3 in_camera = base_to_camera_.inverse() * (base_to_lidar_ * in_lidar);
+  const Vector3 through_graph = graph_.transform("lidar", "camera") * in_lidar;
+  EXPECT_NEAR(through_graph.x(), in_camera.x(), kTolerance);
+  EXPECT_NEAR(through_graph.y(), in_camera.y(), kTolerance);
+  EXPECT_NEAR(through_graph.z(), in_camera.z(), kTolerance);
+}
+
+TEST_F(FrameGraphTest, RepeatedLookupsAreStable) {
+  const FrameGraph::FrameId lidar = graph_.id("lidar");
+  const FrameGraph::FrameId world = graph_.id("world");
+  EXPECT_EQ(graph_.name(lidar), "lidar");
+  const Isometry first = graph_.transform(lidar, world);
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_TRUE(areAlmostEqual(graph_.transform(lidar, world), first, 0.));
+  }
+}
+
+TEST_F(FrameGraphTest, EdgeUpdatesInvalidateTheSubtree) {
+  // Warm every cache first.
+  const Isometry camera_to_lidar = graph_.transform("lidar", "camera");
+  const Isometry map_to_world = graph_.transform("world", "map");
+  graph_.transform("lidar", "world");
+  graph_.transform("world", "lidar");
+
+  odom_to_base_ = Pose(-1., 2., 0., 1.2);
+  graph_.setTransform("base", odom_to_base_);
+
+  const Isometry world_to_lidar = world_to_map_ * map_to_odom_ * odom_to_base_ * base_to_lidar_;
+  EXPECT_TRUE(areAlmostEqual(graph_.transform("lidar", "world"), world_to_lidar, kTolerance));
+  EXPECT_TRUE(areAlmostEqual(graph_.transform("world", "lidar"), world_to_lidar.inverse(), kTolerance));
+  // Pairs within the subtree, or entirely above it, do not depend on the changed edge.
+  EXPECT_TRUE(areAlmostEqual(graph_.transform("lidar", "camera"), camera_to_lidar, kTolerance));
+  EXPECT_TRUE(areAlmostEqual(graph_.transform("world", "map"), map_to_world, kTolerance));
+
+  // Updating an edge closer to the root also reaches the leaves.
+  const Isometry world_to_new_map = Pose(0., 0., 1., 0.);
+  graph_.setTransform("map", world_to_new_map);
+  EXPECT_TRUE(areAlmostEqual(graph_.transform("lidar", "world"),
+                             world_to_new_map * map_to_odom_ * odom_to_base_ * base_to_lidar_, kTolerance));
+}
+
+TEST_F(FrameGraphTest, Errors) {
+  EXPECT_THROW(graph_.addFrame("base"), std::invalid_argument);
+  EXPECT_THROW(graph_.addFrame("wheel", "chassis", Pose(0., 0., 0., 0.)), std::out_of_range);
+  EXPECT_THROW(graph_.transform("base", "chassis"), std::out_of_range);
+  EXPECT_THROW(graph_.transform(graph_.size(), 0), std::out_of_range);
+  EXPECT_THROW(graph_.setTransform("world", Pose(0., 0., 0., 0.)), std::invalid_argument);
+  EXPECT_THROW(graph_.id("chassis"), std::out_of_range);
+  EXPECT_FALSE(graph_.hasFrame("chassis"));
+
+  // A second tree is not connected to the first one.
+  graph_.addFrame("other_world");
+  graph_.addFrame("robot", "other_world", Pose(1., 0., 0., 0.));
+  EXPECT_THROW(graph_.transform("robot", "base"), std::invalid_argument);
+  EXPECT_TRUE(areAlmostEqual(graph_.transform("robot", "other_world"), Pose(1., 0., 0., 0.), kTolerance));
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace math
+}  // namespace ekumen
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
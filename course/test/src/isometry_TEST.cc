@@ -5,10 +5,19 @@
 // Consider including other header files if needed.
 #include "isometry.h"
 
+#include <algorithm>
 #include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <random>
 #include <sstream>
 #include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
 
+#include "allocation_counter.h"
 #include "gtest/gtest.h"
 
 namespace ekumen {
@@ -91,6 +100,9 @@ GTEST_TEST(Vector3Test, Vector3Operations) {
   EXPECT_TRUE(Vector3::kUnitX != std::initializer_list<double>({1., 1., 0}));
   EXPECT_TRUE(Vector3::kUnitY == std::initializer_list<double>({0., 1., 0}));
   EXPECT_TRUE(Vector3::kUnitZ == Vector3::kUnitX.cross(Vector3::kUnitY));
+  EXPECT_TRUE(Vector3::kUnitY == Vector3::kUnitZ.cross(Vector3::kUnitX));
+  EXPECT_TRUE(Vector3::kUnitX == Vector3::kUnitY.cross(Vector3::kUnitZ));
+  EXPECT_EQ(p.cross(q), Vector3(-3., 6., -3.));
   EXPECT_NEAR(Vector3::kUnitX.dot(Vector3::kUnitZ), 0., kTolerance);
 
   Vector3 t;
@@ -101,6 +113,19 @@ GTEST_TEST(Vector3Test, Vector3Operations) {
   EXPECT_EQ(t, p);
 }
 
+GTEST_TEST(Vector3Test, Vector3InlineStorage) {
+  static_assert(std::is_trivially_copyable<Vector3>::value, "Vector3 must be trivially copyable");
+  static_assert(sizeof(Vector3) == 3 * sizeof(double), "Vector3 must store its elements inline");
+
+  Vector3 a{1., 2., 3.};
+  Vector3 b{a};
+  b.x() = 4.;
+  EXPECT_EQ(a, Vector3(1., 2., 3.));
+  EXPECT_EQ(b, Vector3(4., 2., 3.));
+  Vector3 c = std::move(b);
+  EXPECT_EQ(c, Vector3(4., 2., 3.));
+}
+
 GTEST_TEST(Matrix3Test, Matrix3Operations) {
   const double kTolerance{1e-12};
   Matrix3 m1{Vector3{1., 2., 3.}, Vector3{4., 5., 6.}, Vector3{7., 8., 9.}};
@@ -145,6 +170,46 @@ GTEST_TEST(Matrix3Test, Matrix3Operations) {
   }
 }
 
+GTEST_TEST(Matrix3Test, Matrix3InlineStorage) {
+  static_assert(std::is_trivially_copyable<Matrix3>::value, "Matrix3 must be trivially copyable");
+  static_assert(sizeof(Matrix3) == 9 * sizeof(double), "Matrix3 must store its rows inline");
+  static_assert(std::is_trivially_copyable<Isometry>::value, "Isometry must be trivially copyable");
+
+  const Matrix3 m1{1., 2., 3., 4., 5., 6., 7., 8., 9.};
+  Matrix3 m2{m1};
+  m2[1][1] = 0.;
+  EXPECT_EQ(m1[1][1], 5.);
+  EXPECT_EQ(m2[1][1], 0.);
+  // Rows are laid out contiguously in row-major order.
+  EXPECT_EQ(&m1[0][0] + 3, &m1[1][0]);
+  EXPECT_EQ(&m1[0][0] + 6, &m1[2][0]);
+}
+
+GTEST_TEST(Matrix3Test, IndexedAccess) {
+  Matrix3 m{1., 2., 3., 4., 5., 6., 7., 8., 9.};
+  double expected{1.};
+  for (uint32_t i = 0; i < 3; ++i) {
+    for (int j = 0; j < 3; ++j) {
+      EXPECT_EQ(m[i][j], expected);
+      m[i][j] = -expected;
+      expected += 1.;
+    }
+  }
+  EXPECT_EQ(m.r2(), Vector3(-4., -5., -6.));
+  Vector3 v{1., 2., 3.};
+  EXPECT_EQ(&v[0], &v.x());
+  EXPECT_EQ(&v[2], &v.z());
+
+#ifdef EKUMEN_MATH_CHECKED_ACCESS
+  const Matrix3& constant{m};
+  EXPECT_THROW(v[3], std::out_of_range);
+  EXPECT_THROW(v[-1], std::out_of_range);
+  EXPECT_THROW(m[3], std::out_of_range);
+  EXPECT_THROW(constant[3], std::out_of_range);
+  EXPECT_THROW(constant[0][3], std::out_of_range);
+#endif
+}
+
 GTEST_TEST(IsometryTest, IsometryOperations) {
   const double kTolerance{1e-12};
   const Isometry t1 = Isometry::FromTranslation(Vector3{1., 2., 3.});
@@ -175,7 +240,318 @@ GTEST_TEST(IsometryTest, IsometryOperations) {
 
   std::stringstream ss;
   ss << t5;
-  EXPECT_EQ(ss.str(), "[T: (x: 0, y: 0, z: 0), R:[[0.923879533, -0.382683432, 0], [0.382683432, 0.923879533, 0], [0, 0, 1]]]");
+  EXPECT_EQ(ss.str(), "[T: (x: 0, y: 0, z: 0), R:[[0.9238795325112867, -0.3826834323650898, 0], "
+                      "[0.3826834323650898, 0.9238795325112867, 0], [0, 0, 1]]]");
+}
+
+GTEST_TEST(Vector3Test, CompoundOperatorsInPlace) {
+  Vector3 a{1., 2., 3.};
+  a += a;
+  EXPECT_EQ(a, Vector3(2., 4., 6.));
+  a *= a;
+  EXPECT_EQ(a, Vector3(4., 16., 36.));
+  a /= 2.;
+  EXPECT_EQ(a, Vector3(2., 8., 18.));
+  a -= a;
+  EXPECT_EQ(a, Vector3::kZero);
+
+  Matrix3 m{1., 2., 3., 4., 5., 6., 7., 8., 9.};
+  EXPECT_EQ(m / 2., Matrix3({.5, 1., 1.5, 2., 2.5, 3., 3.5, 4., 4.5}));
+  m += m;
+  EXPECT_EQ(m, Matrix3({2., 4., 6., 8., 10., 12., 14., 16., 18.}));
+}
+
+GTEST_TEST(Matrix3Test, ProductAndTranspose) {
+  const Matrix3 m1{1., 2., 3., 4., 5., 6., 7., 8., 10.};
+  const Matrix3 m2{2., 0., 1., 1., 3., 0., 0., 1., 4.};
+  EXPECT_EQ(m1.product(m2), Matrix3({4., 9., 13., 13., 21., 28., 22., 34., 47.}));
+  EXPECT_EQ(m1.product(Matrix3::kIdentity), m1);
+  EXPECT_EQ(m1.transpose(), Matrix3({1., 4., 7., 2., 5., 8., 3., 6., 10.}));
+  EXPECT_EQ(m1.transpose().transpose(), m1);
+
+  EXPECT_TRUE(Matrix3::kIdentity.isOrthonormal(1e-12));
+  EXPECT_FALSE(m1.isOrthonormal(1e-12));
+  EXPECT_FALSE(Matrix3::kOnes.isOrthonormal(1e-12));
+  EXPECT_TRUE(Isometry::RotateAround(Vector3::kUnitY, 0.3).rotation().isOrthonormal(1e-12));
+  Matrix3 not_a_number{Matrix3::kIdentity};
+  not_a_number[0][0] = std::numeric_limits<double>::quiet_NaN();
+  EXPECT_FALSE(not_a_number.isOrthonormal(1e-12));
+  Matrix3 infinite{Matrix3::kIdentity};
+  infinite[2][1] = std::numeric_limits<double>::infinity();
+  EXPECT_FALSE(infinite.isOrthonormal(1e-12));
+}
+
+GTEST_TEST(Matrix3Test, GeneralInverse) {
+  const double kTolerance{1e-12};
+  const Matrix3 m{1., 2., 3., 4., 5., 6., 7., 8., 10.};
+  const Matrix3 expected{-2. / 3., -4. / 3., 1., -2. / 3., 11. / 3., -2., 1., -2., 1.};
+  EXPECT_TRUE(areAlmostEqual(m.inverse(), expected, kTolerance));
+  EXPECT_TRUE(areAlmostEqual(m.product(m.inverse()), Matrix3::kIdentity, kTolerance));
+  EXPECT_TRUE(areAlmostEqual(m.inverse().product(m), Matrix3::kIdentity, kTolerance));
+  EXPECT_THROW(Matrix3::kOnes.inverse(), std::domain_error);
+}
+
+GTEST_TEST(Matrix3Test, TryInverse) {
+  const Matrix3 m{1., 2., 3., 4., 5., 6., 7., 8., 10.};
+  const InverseResult result = m.tryInverse();
+  ASSERT_TRUE(result.ok());
+  EXPECT_EQ(result.status, InverseStatus::kOk);
+  const Matrix3 inverse = m.inverse();
+  EXPECT_EQ(std::memcmp(&result.inverse, &inverse, sizeof(inverse)), 0);
+  // Largest column sums: 19 for m, 7 for its inverse.
+  EXPECT_NEAR(result.condition, 133., 1e-12);
+
+  const Matrix3 rotation = Isometry::RotateAround(Vector3::kUnitY, 0.3).rotation();
+  EXPECT_TRUE(rotation.tryInverse().ok());
+  EXPECT_EQ(Matrix3::kIdentity.tryInverse().condition, 1.);
+  EXPECT_LT(rotation.tryInverse().condition, 3.);
+
+  const Matrix3 nearly_singular{1., 0., 0., 0., 1., 0., 0., 0., 1e-10};
+  EXPECT_TRUE(nearly_singular.tryInverse().ok());
+  EXPECT_NEAR(nearly_singular.tryInverse().condition, 1e10, 1.);
+
+  for (const Matrix3& singular : {Matrix3::kOnes, Matrix3::kZero}) {
+    const InverseResult failed = singular.tryInverse();
+    EXPECT_FALSE(failed.ok());
+    EXPECT_EQ(failed.status, InverseStatus::kSingular);
+    EXPECT_EQ(failed.inverse, Matrix3::kZero);
+    EXPECT_TRUE(std::isinf(failed.condition));
+  }
+
+  const InverseResultf result_float = Matrix3f(m).tryInverse();
+  ASSERT_TRUE(result_float.ok());
+  EXPECT_NEAR(result_float.condition, 133.f, 1e-3f);
+  EXPECT_FALSE(Matrix3f::kZero.tryInverse().ok());
+}
+
+GTEST_TEST(IsometryTest, RigidInverse) {
+  const double kTolerance{1e-12};
+  const Isometry t{Isometry::FromTranslation(Vector3{1., -2., 3.}) *
+                   Isometry::FromEulerAngles(M_PI / 3., -M_PI / 5., M_PI / 7.)};
+  const Isometry identity{Matrix3::kIdentity};
+
+  EXPECT_TRUE(t.rotation().isOrthonormal(kTolerance));
+  EXPECT_TRUE(areAlmostEqual(t * t.inverse(), identity, kTolerance));
+  EXPECT_TRUE(areAlmostEqual(t.inverse() * t, identity, kTolerance));
+  EXPECT_TRUE(areAlmostEqual(t.inverse().inverse(), t, kTolerance));
+
+  const Vector3 p{4., 5., 6.};
+  const Vector3 q = t.inverse() * (t * p);
+  EXPECT_NEAR(q.x(), p.x(), kTolerance);
+  EXPECT_NEAR(q.y(), p.y(), kTolerance);
+  EXPECT_NEAR(q.z(), p.z(), kTolerance);
+}
+
+GTEST_TEST(IsometryTest, Normalize) {
+  // A long chain of small float steps, normalized now and then as a long-lived pose would be.
+  const Vector3f axis = Vector3f(1.f, 2.f, 2.f) / 3.f;
+  const Isometryf step = Isometryf::RotateAround(axis, 1e-3f);
+  Isometryf pose = Isometryf::FromTranslation(Vector3f(1.f, 2.f, 3.f));
+  for (int i = 1; i <= 100000; ++i) {
+    pose = pose * step;
+    if (i % 1000 == 0) {
+      pose.normalize();
+    }
+  }
+  EXPECT_TRUE(pose.rotation().isOrthonormal(1e-6f));
+  EXPECT_EQ(pose.translation(), Vector3f(1.f, 2.f, 3.f));
+  const Matrix3f expected = Isometryf::RotateAround(axis, std::fmod(100.f, 2.f * float(M_PI))).rotation();
+  for (uint32_t row = 0; row < 3; ++row) {
+    for (int column = 0; column < 3; ++column) {
+      EXPECT_NEAR(pose.rotation()[row][column], expected[row][column], 1e-3f);
+    }
+  }
+
+  // Exact rotations stay put.
+  Isometry t{Vector3{1., -2., 3.}, Isometry::FromEulerAngles(M_PI / 3., -M_PI / 5., M_PI / 7.).rotation()};
+  const Isometry before = t;
+  t.normalize();
+  EXPECT_TRUE(areAlmostEqual(t, before, 1e-15));
+}
+
+// Compile time frames: every check below is evaluated by the compiler.
+constexpr Isometry kBaseToLidar{Vector3{0.5, 0., 1.2}, Matrix3{0., -1., 0., 1., 0., 0., 0., 0., 1.}};
+constexpr Isometry kLidarToCamera{Vector3{0., 0.1, -0.2}, Matrix3{1., 0., 0., 0., 0., -1., 0., 1., 0.}};
+constexpr Isometry kBaseToCamera = kBaseToLidar * kLidarToCamera;
+constexpr Vector3 kCameraOrigin = kBaseToCamera * Vector3{0., 0., 0.};
+
+static_assert(Vector3(1., 2., 3.)[1] == 2., "");
+static_assert(Vector3({1., 2., 3.}).z() == 3., "");
+static_assert((Vector3(1., 2., 3.) + Vector3(4., 5., 6.)).x() == 5., "");
+static_assert((2. * Vector3(1., 2., 3.) - Vector3(1., 1., 1.)).z() == 5., "");
+static_assert(Vector3(1., 2., 3.).dot(Vector3(4., 5., 6.)) == 32., "");
+static_assert(Vector3(1., 0., 0.).cross(Vector3(0., 1., 0.)).z() == 1., "");
+static_assert((Vector3(1., 2., 3.) += Vector3(1., 1., 1.)).y() == 3., "");
+static_assert(Matrix3({1., 2., 3., 4., 5., 6., 7., 8., 10.}).det() == -3., "");
+static_assert(Matrix3({1., 2., 3., 4., 5., 6., 7., 8., 9.}).transpose()[0][2] == 7., "");
+static_assert(Matrix3({1., 2., 3., 4., 5., 6., 7., 8., 9.}).col(1).z() == 8., "");
+static_assert((Matrix3({1., 2., 3., 4., 5., 6., 7., 8., 9.}) * Vector3(1., 1., 1.)).y() == 15., "");
+static_assert(kBaseToLidar.rotation().isOrthonormal(1e-12), "");
+static_assert(kBaseToCamera.rotation()[0][2] == 1., "");
+static_assert(kBaseToCamera.rotation()[2][1] == 1., "");
+static_assert(kCameraOrigin.x() == 0.4 && kCameraOrigin.y() == 0. && kCameraOrigin.z() == 1., "");
+static_assert((kBaseToCamera.inverse() * kCameraOrigin).z() == 0., "");
+static_assert(Isometry::FromTranslation(Vector3(1., 2., 3.)).transform(Vector3(1., 1., 1.)).z() == 4., "");
+
+GTEST_TEST(IsometryTest, CompileTimeFrames) {
+  const double kTolerance{1e-12};
+  EXPECT_TRUE(areAlmostEqual(kBaseToCamera, kBaseToLidar.compose(kLidarToCamera), kTolerance));
+  EXPECT_EQ(kCameraOrigin, Vector3(0.4, 0., 1.));
+  EXPECT_EQ(Vector3::kUnitX, Vector3(1., 0., 0.));
+  EXPECT_EQ(Matrix3::kIdentity, Matrix3({1., 0., 0., 0., 1., 0., 0., 0., 1.}));
+}
+
+GTEST_TEST(IsometryTest, BatchTransform) {
+  const double kTolerance{1e-12};
+  const Isometry t{Vector3{1., -2., 3.}, Isometry::RotateAround(Vector3::kUnitZ, M_PI / 3.).rotation()};
+  const std::vector<Vector3> points{Vector3(1., 2., 3.), Vector3(-4., 0.5, 6.), Vector3::kZero, Vector3::kUnitY};
+
+  std::vector<Vector3> out(points.size());
+  t.transform(points.data(), out.data(), points.size());
+  for (size_t i = 0; i < points.size(); ++i) {
+    EXPECT_EQ(out[i], t.transform(points[i]));
+  }
+
+  // In place.
+  std::vector<Vector3> in_place{points};
+  t.transform(in_place.data(), in_place.data(), in_place.size());
+  for (size_t i = 0; i < points.size(); ++i) {
+    EXPECT_EQ(in_place[i], out[i]);
+  }
+
+  // Struct of arrays, in place.
+  std::vector<double> x, y, z;
+  for (const Vector3& point : points) {
+    x.push_back(point.x());
+    y.push_back(point.y());
+    z.push_back(point.z());
+  }
+  t.transform(x.data(), y.data(), z.data(), x.data(), y.data(), z.data(), points.size());
+  for (size_t i = 0; i < points.size(); ++i) {
+    EXPECT_NEAR(x[i], out[i].x(), kTolerance);
+    EXPECT_NEAR(y[i], out[i].y(), kTolerance);
+    EXPECT_NEAR(z[i], out[i].z(), kTolerance);
+  }
+
+  // Empty input is a no-op.
+  t.transform(points.data(), out.data(), 0);
+}
+
+GTEST_TEST(IsometryTest, SinglePrecision) {
+  static_assert(sizeof(Vector3f) == 3 * sizeof(float), "Vector3f must store floats inline");
+  static_assert(sizeof(Matrix3f) == 9 * sizeof(float), "Matrix3f must store floats inline");
+  static_assert(std::is_trivially_copyable<Isometryf>::value, "Isometryf must be trivially copyable");
+  static_assert(!std::is_convertible<Vector3, Vector3f>::value, "Precision changes must be explicit");
+  static_assert(!std::is_convertible<Isometryf, Isometry>::value, "Precision changes must be explicit");
+
+  const Vector3f p{1.f, 2.f, 3.f};
+  const Vector3f q{4.f, 5.f, 6.f};
+  EXPECT_EQ(p + q, Vector3f(5.f, 7.f, 9.f));
+  EXPECT_EQ(p.cross(q), Vector3f(-3.f, 6.f, -3.f));
+  EXPECT_FLOAT_EQ(p.dot(q), 32.f);
+  EXPECT_EQ(Vector3f(Vector3{1., 2., 3.}), p);
+  EXPECT_EQ(Vector3(p), Vector3(1., 2., 3.));
+
+  const Isometry t_double{Vector3{1., -2., 3.}, Isometry::RotateAround(Vector3::kUnitZ, M_PI / 3.).rotation()};
+  const Isometryf t_float{t_double};
+  const Vector3f transformed = t_float * p;
+  const Vector3 expected = t_double * Vector3(p);
+  EXPECT_NEAR(transformed.x(), expected.x(), 1e-5);
+  EXPECT_NEAR(transformed.y(), expected.y(), 1e-5);
+  EXPECT_NEAR(transformed.z(), expected.z(), 1e-5);
+  EXPECT_TRUE(areAlmostEqual(Isometry(t_float.inverse() * t_float), Isometry::FromTranslation(Vector3::kZero), 1e-6));
+  EXPECT_THROW(Matrix3f::kZero.inverse(), std::domain_error);
+
+  // The float SoA path goes through the single precision kernels.
+  float x[]{1.f, 4.f, -2.f};
+  float y[]{2.f, 5.f, 0.5f};
+  float z[]{3.f, 6.f, 8.f};
+  t_float.transform(x, y, z, x, y, z, 3);
+  EXPECT_EQ(Vector3f(x[0], y[0], z[0]), transformed);
+}
+
+// Distance from |value| to |reference| in units in the last place of the float nearest to
+// |reference|.
+double UlpError(const float value, const long double reference) {
+  const float magnitude = std::fabs(static_cast<float>(reference));
+  const float ulp = std::nextafter(magnitude, std::numeric_limits<float>::infinity()) - magnitude;
+  return static_cast<double>(std::fabs(static_cast<long double>(value) - reference) / ulp);
+}
+
+GTEST_TEST(Matrix3Test, CrossAndDetPrecision) {
+  // Nearly parallel vectors and nearly singular matrices, where the products cancel. Products
+  // of floats are exact in long double, which makes it a reference for single precision.
+  std::mt19937 generator(19);
+  std::uniform_real_distribution<float> distribution(-1.f, 1.f);
+  const auto random = [&]() { return Vector3f{distribution(generator), distribution(generator), distribution(generator)}; };
+  double max_cross_error{0.};
+  double max_naive_cross_error{0.};
+  double det_error{0.};
+  double naive_det_error{0.};
+  for (int i = 0; i < 10000; ++i) {
+    const Vector3f a = random();
+    const Vector3f b = a * 3.f + random() * 1e-4f;
+    const Vector3f cross = a.cross(b);
+    const long double ax{a.x()}, ay{a.y()}, az{a.z()}, bx{b.x()}, by{b.y()}, bz{b.z()};
+    const long double reference[3]{ay * bz - by * az, az * bx - bz * ax, ax * by - bx * ay};
+    const float naive[3]{a.y() * b.z() - b.y() * a.z(), a.z() * b.x() - b.z() * a.x(), a.x() * b.y() - b.x() * a.y()};
+    for (int k = 0; k < 3; ++k) {
+      max_cross_error = std::max(max_cross_error, UlpError(cross[k], reference[k]));
+      max_naive_cross_error = std::max(max_naive_cross_error, UlpError(naive[k], reference[k]));
+    }
+
+    const Vector3f r = random();
+    const Matrix3f m{r, a, b};
+    const long double reference_det = r.x() * (ay * bz - az * by) - r.y() * (ax * bz - az * bx) +
+                                      r.z() * (ax * by - ay * bx);
+    const float naive_det = r.x() * (a.y() * b.z() - a.z() * b.y()) - r.y() * (a.x() * b.z() - a.z() * b.x()) +
+                            r.z() * (a.x() * b.y() - a.y() * b.x());
+    det_error += UlpError(m.det(), reference_det);
+    naive_det_error += UlpError(naive_det, reference_det);
+  }
+  RecordProperty("max_cross_ulps", std::to_string(max_cross_error));
+  RecordProperty("max_naive_cross_ulps", std::to_string(max_naive_cross_error));
+  RecordProperty("mean_det_ulps", std::to_string(det_error / 10000));
+  RecordProperty("mean_naive_det_ulps", std::to_string(naive_det_error / 10000));
+#ifdef EKUMEN_MATH_FMA
+  // Kahan's difference of products is within 1.5 ulp.
+  EXPECT_LE(max_cross_error, 1.5);
+  EXPECT_LT(det_error, naive_det_error / 2.);
+#else
+  EXPECT_EQ(max_cross_error, max_naive_cross_error);
+  EXPECT_EQ(det_error, naive_det_error);
+#endif
+}
+
+GTEST_TEST(IsometryTest, ConcurrentMathDoesNotAllocate) {
+  // Vector3 and Matrix3 keep their values inline, so threads doing math at once never contend
+  // on the global allocator.
+  constexpr size_t kThreads{4};
+  std::vector<uint64_t> allocations(kThreads, 1);
+  std::vector<Vector3> results(kThreads);
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < kThreads; ++t) {
+    threads.emplace_back([&allocations, &results, t]() {
+      const uint64_t before = ekumen::test::ThreadAllocationCount();
+      const Isometry step{Vector3{0.1, 0., 0.}, Isometry::RotateAround(Vector3::kUnitZ, 0.01 * (t + 1)).rotation()};
+      Isometry pose = Isometry::FromTranslation(Vector3::kZero);
+      Vector3 point{1., 2., 3.};
+      for (int i = 0; i < 10000; ++i) {
+        pose = pose * step;
+        const Matrix3 rotation = pose.rotation().product(pose.inverse().rotation());
+        point = pose * point.cross(Vector3::kUnitX) / (1. + point.norm()) + rotation * Vector3::kUnitY * rotation.det();
+      }
+      results[t] = point;
+      allocations[t] = ekumen::test::ThreadAllocationCount() - before;
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  for (size_t t = 0; t < kThreads; ++t) {
+    EXPECT_EQ(allocations[t], 0u);
+    EXPECT_TRUE(std::isfinite(results[t].norm()));
+  }
 }
 
 }  // namespace
@@ -0,0 +1,183 @@
+#include "lie.h"
+
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "isometry.h"
+
+#include "gtest/gtest.h"
+
+namespace ekumen {
+namespace math {
+namespace test {
+namespace {
+
+template <class T>
+testing::AssertionResult AreNear(const Vector3T<T>& a, const Vector3T<T>& b, const T tolerance) {
+  for (int i = 0; i < 3; ++i) {
+    if (std::fabs(a[i] - b[i]) > tolerance) {
+      return testing::AssertionFailure() << a << " and " << b << " differ by more than " << tolerance;
+    }
+  }
+  return testing::AssertionSuccess();
+}
+
+template <class T>
+testing::AssertionResult AreNear(const Matrix3T<T>& a, const Matrix3T<T>& b, const T tolerance) {
+  for (uint32_t row = 0; row < 3; ++row) {
+    if (!AreNear(a[row], b[row], tolerance)) {
+      return testing::AssertionFailure() << a << " and " << b << " differ by more than " << tolerance;
+    }
+  }
+  return testing::AssertionSuccess();
+}
+
+template <class T>
+testing::AssertionResult AreNear(const IsometryT<T>& a, const IsometryT<T>& b, const T tolerance) {
+  if (!AreNear(a.rotation(), b.rotation(), tolerance) || !AreNear(a.translation(), b.translation(), tolerance)) {
+    return testing::AssertionFailure() << a << " and " << b << " differ by more than " << tolerance;
+  }
+  return testing::AssertionSuccess();
+}
+
+template <class T>
+Vector3T<T> RandomUnitVector(std::mt19937& generator) {
+  std::normal_distribution<T> distribution(0., 1.);
+  const Vector3T<T> vector(distribution(generator), distribution(generator), distribution(generator));
+  return vector / vector.norm();
+}
+
+// Angles from zero to pi, crowding the Taylor thresholds and both ends.
+template <class T>
+std::vector<T> TestAngles() {
+  std::vector<T> angles{0, T(1e-30), T(1e-12), T(1e-6), T(1e-3), T(9.99e-3), T(1.001e-2), T(0.2), T(0.224),
+                        T(0.5), T(1), T(2), T(2.6), T(3), T(M_PI - 1e-3), T(M_PI - 1e-6)};
+  for (int i = 0; i < 200; ++i) {
+    angles.push_back(T(M_PI) * T(i) / 200);
+  }
+  return angles;
+}
+
+GTEST_TEST(LieTest, ExpSO3MatchesRotateAround) {
+  std::mt19937 generator(1);
+  for (const double angle : TestAngles<double>()) {
+    const Vector3 axis = RandomUnitVector<double>(generator);
+    EXPECT_TRUE(AreNear(ExpSO3(axis * angle), Isometry::RotateAround(axis, angle).rotation(), 1e-15)) << angle;
+  }
+  EXPECT_EQ(ExpSO3(Vector3::kZero), Matrix3::kIdentity);
+}
+
+template <class T>
+void ExpectSO3RoundTrip(const T tolerance) {
+  std::mt19937 generator(2);
+  for (const T angle : TestAngles<T>()) {
+    const Vector3T<T> rotation_vector = RandomUnitVector<T>(generator) * angle;
+    const Matrix3T<T> rotation = ExpSO3(rotation_vector);
+    EXPECT_TRUE(rotation.isOrthonormal(tolerance)) << angle;
+    EXPECT_TRUE(AreNear(LogSO3(rotation), rotation_vector, tolerance)) << angle;
+  }
+}
+
+GTEST_TEST(LieTest, SO3RoundTrip) {
+  ExpectSO3RoundTrip<double>(1e-12);
+  ExpectSO3RoundTrip<float>(1e-4f);
+}
+
+GTEST_TEST(LieTest, LogSO3AtPi) {
+  for (const Vector3& axis : {Vector3::kUnitX, Vector3::kUnitY, Vector3::kUnitZ, Vector3(1., 2., -2.) / 3.}) {
+    const Vector3 rotation_vector = LogSO3(Isometry::RotateAround(axis, M_PI).rotation());
+    EXPECT_NEAR(rotation_vector.norm(), M_PI, 1e-12);
+    // Rotations by pi around n and -n are the same.
+    EXPECT_NEAR(std::fabs(rotation_vector.dot(axis)), M_PI, 1e-12);
+  }
+}
+
+template <class T>
+void ExpectSE3RoundTrip(const T tolerance) {
+  std::mt19937 generator(3);
+  std::uniform_real_distribution<T> distance(-5., 5.);
+  for (const T angle : TestAngles<T>()) {
+    const TwistT<T> twist{Vector3T<T>(distance(generator), distance(generator), distance(generator)),
+                          RandomUnitVector<T>(generator) * angle};
+    const IsometryT<T> isometry = ExpSE3(twist);
+    const TwistT<T> log = LogSE3(isometry);
+    EXPECT_TRUE(AreNear(log.angular, twist.angular, tolerance)) << angle;
+    EXPECT_TRUE(AreNear(log.linear, twist.linear, 10 * tolerance)) << angle;
+    EXPECT_TRUE(AreNear(ExpSE3(log), isometry, 10 * tolerance)) << angle;
+  }
+}
+
+GTEST_TEST(LieTest, SE3RoundTrip) {
+  ExpectSE3RoundTrip<double>(1e-12);
+  ExpectSE3RoundTrip<float>(1e-4f);
+}
+
+GTEST_TEST(LieTest, ScrewMotions) {
+  // No rotation: a pure translation.
+  const Twist translation{Vector3(1., 2., 3.), Vector3::kZero};
+  EXPECT_TRUE(AreNear(ExpSE3(translation), Isometry::FromTranslation(Vector3(1., 2., 3.)), 0.));
+
+  // A quarter turn around z while moving along x traces a quarter circle of radius 2 / pi.
+  const Twist arc{Vector3::kUnitX, Vector3::kUnitZ * (M_PI / 2.)};
+  const Isometry end = ExpSE3(arc);
+  EXPECT_TRUE(AreNear(end.translation(), Vector3(2. / M_PI, 2. / M_PI, 0.), 1e-15));
+  EXPECT_TRUE(AreNear(end.rotation(), Isometry::RotateAround(Vector3::kUnitZ, M_PI / 2.).rotation(), 1e-15));
+}
+
+GTEST_TEST(LieTest, TaylorThresholdIsSeamless) {
+  // Both sides of each threshold agree to machine precision.
+  for (const double angle : {1e-2, 0.2, 0.224}) {
+    const Twist below{Vector3(1., -2., 0.5), Vector3(0.6, 0., 0.8) * std::nextafter(angle, 0.)};
+    const Twist above{Vector3(1., -2., 0.5), Vector3(0.6, 0., 0.8) * std::nextafter(angle, 1.)};
+    EXPECT_TRUE(AreNear(ExpSE3(below), ExpSE3(above), 1e-15));
+  }
+  for (const float angle : {0.2f, 0.224f}) {
+    const Twistf below{Vector3f(1.f, -2.f, 0.5f), Vector3f(0.6f, 0.f, 0.8f) * std::nextafter(angle, 0.f)};
+    const Twistf above{Vector3f(1.f, -2.f, 0.5f), Vector3f(0.6f, 0.f, 0.8f) * std::nextafter(angle, 1.f)};
+    EXPECT_TRUE(AreNear(ExpSE3(below), ExpSE3(above), 1e-6f));
+    EXPECT_TRUE(AreNear(LogSE3(ExpSE3(below)).linear, LogSE3(ExpSE3(above)).linear, 1e-6f));
+  }
+}
+
+GTEST_TEST(LieTest, BatchMatchesSingle) {
+  std::mt19937 generator(4);
+  std::uniform_real_distribution<double> distance(-5., 5.);
+  std::vector<Twist> twists;
+  for (const double angle : TestAngles<double>()) {
+    twists.push_back(Twist{Vector3(distance(generator), distance(generator), distance(generator)),
+                           RandomUnitVector<double>(generator) * angle});
+  }
+  std::vector<Isometry> isometries(twists.size(), Isometry::FromTranslation(Vector3::kZero));
+  ExpSE3Batch(twists.data(), isometries.data(), twists.size());
+  std::vector<Twist> logs(twists.size());
+  LogSE3Batch(isometries.data(), logs.data(), isometries.size());
+  for (size_t i = 0; i < twists.size(); ++i) {
+    EXPECT_TRUE(AreNear(isometries[i], ExpSE3(twists[i]), 0.));
+    EXPECT_TRUE(AreNear(logs[i].linear, LogSE3(isometries[i]).linear, 0.));
+    EXPECT_TRUE(AreNear(logs[i].angular, LogSE3(isometries[i]).angular, 0.));
+  }
+}
+
+GTEST_TEST(LieTest, Interpolate) {
+  const Isometry from{Vector3(1., 0., 0.), Isometry::RotateAround(Vector3::kUnitZ, 0.2).rotation()};
+  const Isometry to{Vector3(3., 2., 1.), Isometry::RotateAround(Vector3(1., 2., 2.) / 3., 1.4).rotation()};
+  EXPECT_TRUE(AreNear(Interpolate(from, to, 0.), from, 1e-15));
+  EXPECT_TRUE(AreNear(Interpolate(from, to, 1.), to, 1e-14));
+  // The midpoint is halfway along the screw: one more half step reaches |to|.
+  const Isometry middle = Interpolate(from, to, 0.5);
+  const Isometry half_step = from.inverse() * middle;
+  EXPECT_TRUE(AreNear(middle * half_step, to, 1e-14));
+  EXPECT_TRUE(AreNear(LogSE3(half_step).angular * 2., LogSE3(from.inverse() * to).angular, 1e-14));
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace math
+}  // namespace ekumen
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
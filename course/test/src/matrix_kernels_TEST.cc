@@ -0,0 +1,187 @@
+#include "matrix_kernels.h"
+
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "isometry.h"
+
+#include "gtest/gtest.h"
+
+namespace ekumen {
+namespace math {
+namespace test {
+namespace {
+
+const std::vector<SimdLevel> kAllLevels{SimdLevel::kScalar, SimdLevel::kSse42, SimdLevel::kAvx2, SimdLevel::kNeon};
+// Odd sizes exercise the scalar tails of the vector kernels.
+const std::vector<size_t> kSizes{0, 1, 3, 5, 8, 17, 1027};
+
+template <class T>
+std::vector<Matrix3T<T>> RandomMatrices(size_t count, unsigned seed) {
+  std::mt19937 generator(seed);
+  std::uniform_real_distribution<T> distribution(-10., 10.);
+  std::vector<Matrix3T<T>> matrices;
+  for (size_t i = 0; i < count; ++i) {
+    Matrix3T<T> matrix;
+    for (uint32_t row = 0; row < 3; ++row) {
+      matrix[row] = Vector3T<T>(distribution(generator), distribution(generator), distribution(generator));
+    }
+    matrices.push_back(matrix);
+  }
+  return matrices;
+}
+
+template <class T>
+bool SameBits(const Matrix3T<T>& a, const Matrix3T<T>& b) {
+  return std::memcmp(&a, &b, sizeof(a)) == 0;
+}
+
+template <class T>
+testing::AssertionResult MatchesInverse(const Matrix3T<T>& inverse, const Matrix3T<T>& matrix) {
+  const Matrix3T<T> expected = matrix.inverse();
+#ifdef EKUMEN_MATH_FMA
+  // Matrix3T::det() is fused in this build and the kernels are not.
+  for (uint32_t row = 0; row < 3; ++row) {
+    for (int column = 0; column < 3; ++column) {
+      const T difference = std::abs(inverse[row][column] - expected[row][column]);
+      if (difference > T(1e-4) * std::abs(expected[row][column]) + T(1e-6)) {
+        return testing::AssertionFailure() << "Element " << row << ", " << column << " differs by " << difference;
+      }
+    }
+  }
+  return testing::AssertionSuccess();
+#else
+  return SameBits(inverse, expected) ? testing::AssertionSuccess()
+                                     : testing::AssertionFailure() << inverse << " != " << expected;
+#endif
+}
+
+template <class T>
+void ExpectInverseMatchesMatrix3() {
+  for (const size_t size : kSizes) {
+    const std::vector<Matrix3T<T>> matrices = RandomMatrices<T>(size, 7);
+    for (const SimdLevel level : kAllLevels) {
+      if (!IsSupported(level)) {
+        continue;
+      }
+      std::vector<Matrix3T<T>> out(size);
+      std::vector<uint64_t> singular(SingularMaskWords(size), ~uint64_t{0});
+      ASSERT_EQ(InverseBatch(level, matrices.data(), out.data(), size, singular.data()), 0u);
+      for (const uint64_t word : singular) {
+        EXPECT_EQ(word, 0u);
+      }
+      for (size_t i = 0; i < size; ++i) {
+        ASSERT_TRUE(MatchesInverse(out[i], matrices[i])) << ToString(level) << " matrix " << i;
+      }
+    }
+  }
+}
+
+template <class T>
+void ExpectProductMatchesMatrix3() {
+  for (const size_t size : kSizes) {
+    const std::vector<Matrix3T<T>> a = RandomMatrices<T>(size, 3);
+    const std::vector<Matrix3T<T>> b = RandomMatrices<T>(size, 4);
+    for (const SimdLevel level : kAllLevels) {
+      if (!IsSupported(level)) {
+        continue;
+      }
+      std::vector<Matrix3T<T>> out(size);
+      ProductBatch(level, a.data(), b.data(), out.data(), size);
+      for (size_t i = 0; i < size; ++i) {
+        ASSERT_TRUE(SameBits(out[i], a[i].product(b[i]))) << ToString(level) << " matrix " << i;
+      }
+    }
+  }
+}
+
+GTEST_TEST(MatrixKernelsTest, InverseMatchesMatrix3Inverse) {
+  ExpectInverseMatchesMatrix3<double>();
+  ExpectInverseMatchesMatrix3<float>();
+}
+
+GTEST_TEST(MatrixKernelsTest, ProductMatchesMatrix3Product) {
+  ExpectProductMatchesMatrix3<double>();
+  ExpectProductMatchesMatrix3<float>();
+}
+
+GTEST_TEST(MatrixKernelsTest, ReportsSingularMatrices) {
+  std::vector<Matrix3> matrices = RandomMatrices<double>(130, 11);
+  const std::vector<size_t> singular_indices{0, 5, 64, 70, 129};
+  for (const size_t index : singular_indices) {
+    // A zero row makes the determinant exactly zero, repeated rows only up to rounding.
+    matrices[index][2] = Vector3::kZero;
+  }
+  matrices[70] = Matrix3::kZero;
+  const std::vector<Matrix3> input = matrices;
+
+  for (const SimdLevel level : kAllLevels) {
+    if (!IsSupported(level)) {
+      continue;
+    }
+    std::vector<Matrix3> out(matrices.size());
+    std::vector<uint64_t> singular(SingularMaskWords(matrices.size()));
+    ASSERT_EQ(singular.size(), 3u);
+    EXPECT_EQ(InverseBatch(level, matrices.data(), out.data(), matrices.size(), singular.data()),
+              singular_indices.size());
+    EXPECT_EQ(singular[0], (uint64_t{1} << 0) | (uint64_t{1} << 5));
+    EXPECT_EQ(singular[1], (uint64_t{1} << 0) | (uint64_t{1} << 6));
+    EXPECT_EQ(singular[2], uint64_t{1} << 1);
+    for (size_t i = 0; i < matrices.size(); ++i) {
+      const bool is_singular = (singular[i / 64] >> (i % 64)) & 1;
+      if (is_singular) {
+        EXPECT_THROW(matrices[i].inverse(), std::domain_error);
+        EXPECT_TRUE(SameBits(out[i], Matrix3::kZero));
+      } else {
+        EXPECT_TRUE(MatchesInverse(out[i], matrices[i]));
+      }
+    }
+
+    // In place, and without a mask.
+    std::vector<Matrix3> in_place = input;
+    EXPECT_EQ(InverseBatch(level, in_place.data(), in_place.data(), in_place.size(), nullptr),
+              singular_indices.size());
+    for (size_t i = 0; i < in_place.size(); ++i) {
+      EXPECT_TRUE(SameBits(in_place[i], out[i]));
+    }
+  }
+}
+
+GTEST_TEST(MatrixKernelsTest, InverseTimesMatrixIsIdentity) {
+  const std::vector<Matrix3> matrices = RandomMatrices<double>(64, 13);
+  std::vector<Matrix3> inverses(matrices.size());
+  std::vector<Matrix3> products(matrices.size());
+  InverseBatch(matrices.data(), inverses.data(), matrices.size(), nullptr);
+  ProductBatch(matrices.data(), inverses.data(), products.data(), matrices.size());
+  for (const Matrix3& product : products) {
+    for (uint32_t row = 0; row < 3; ++row) {
+      for (int column = 0; column < 3; ++column) {
+        EXPECT_NEAR(product[row][column], row == static_cast<uint32_t>(column) ? 1. : 0., 1e-9);
+      }
+    }
+  }
+}
+
+GTEST_TEST(MatrixKernelsTest, UnsupportedLevelThrows) {
+  Matrix3 matrix{Matrix3::kIdentity};
+  for (const SimdLevel level : kAllLevels) {
+    if (IsSupported(level)) {
+      continue;
+    }
+    EXPECT_THROW(InverseBatch(level, &matrix, &matrix, 1, nullptr), std::invalid_argument);
+    EXPECT_THROW(ProductBatch(level, &matrix, &matrix, &matrix, 1), std::invalid_argument);
+  }
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace math
+}  // namespace ekumen
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
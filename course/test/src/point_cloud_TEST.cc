@@ -0,0 +1,165 @@
+#include "point_cloud.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace ekumen {
+namespace math {
+namespace test {
+namespace {
+
+constexpr double kTolerance{1e-12};
+
+bool IsAligned(const void* pointer) {
+  return reinterpret_cast<uintptr_t>(pointer) % 64 == 0;
+}
+
+GTEST_TEST(PointCloudTest, StoresPointsAsAlignedArrays) {
+  PointCloud cloud;
+  EXPECT_TRUE(cloud.empty());
+  for (int i = 0; i < 100; ++i) {
+    cloud.push_back(Vector3(i, 2. * i, 3. * i));
+  }
+  EXPECT_EQ(cloud.size(), 100u);
+  EXPECT_TRUE(IsAligned(cloud.x()));
+  EXPECT_TRUE(IsAligned(cloud.y()));
+  EXPECT_TRUE(IsAligned(cloud.z()));
+  EXPECT_EQ(cloud.x()[10], 10.);
+  EXPECT_EQ(cloud.y()[10], 20.);
+  EXPECT_EQ(cloud.z()[10], 30.);
+
+  const PointCloud& const_cloud = cloud;
+  EXPECT_EQ(const_cloud[7], Vector3(7., 14., 21.));
+
+  cloud.resize(120);
+  EXPECT_EQ(static_cast<Vector3>(cloud[119]), Vector3::kZero);
+  cloud.clear();
+  EXPECT_TRUE(cloud.empty());
+
+  const PointCloudf float_cloud(33);
+  EXPECT_TRUE(IsAligned(float_cloud.x()));
+  EXPECT_EQ(float_cloud[32], Vector3f::kZero);
+}
+
+GTEST_TEST(PointCloudTest, IteratorsYieldPointViews) {
+  PointCloud cloud;
+  cloud.push_back(Vector3(1., 2., 3.));
+  cloud.push_back(Vector3(4., 5., 6.));
+  cloud.push_back(Vector3(7., 8., 9.));
+
+  std::vector<Vector3> copied;
+  const PointCloud& const_cloud = cloud;
+  for (const Vector3 point : const_cloud) {
+    copied.push_back(point);
+  }
+  ASSERT_EQ(copied.size(), 3u);
+  EXPECT_EQ(copied[1], Vector3(4., 5., 6.));
+  EXPECT_EQ(cloud.end() - cloud.begin(), 3);
+  EXPECT_EQ(std::distance(const_cloud.begin(), const_cloud.end()), 3);
+
+  // Views write through to the arrays.
+  for (auto point : cloud) {
+    point.z() = -point.z();
+  }
+  EXPECT_EQ(cloud.z()[2], -9.);
+  cloud[0] = Vector3(0., 0., 1.);
+  EXPECT_EQ(cloud.x()[0], 0.);
+  EXPECT_EQ(cloud.z()[0], 1.);
+  cloud[1] = cloud[2];
+  EXPECT_EQ(const_cloud[1], Vector3(7., 8., -9.));
+  EXPECT_EQ(static_cast<Vector3>(*(cloud.begin() + 2)), Vector3(7., 8., -9.));
+
+  const size_t above = std::count_if(const_cloud.begin(), const_cloud.end(),
+                                     [](const Vector3& point) { return point.x() > 5.; });
+  EXPECT_EQ(above, 2u);
+}
+
+GTEST_TEST(PointCloudTest, IteratorsAreRandomAccess) {
+  PointCloud cloud;
+  for (int i = 0; i < 5; ++i) {
+    cloud.push_back(Vector3(i, 0., 0.));
+  }
+  const PointCloud& const_cloud = cloud;
+  const PointCloud::const_iterator begin = const_cloud.begin();
+  const PointCloud::const_iterator middle = 2 + begin;
+  EXPECT_TRUE(middle == begin + 2);
+  EXPECT_TRUE(begin < middle && middle > begin);
+  EXPECT_TRUE(begin <= middle && middle >= begin && middle <= middle && middle >= middle);
+  EXPECT_FALSE(middle < middle || middle > middle);
+  EXPECT_EQ(middle[1], Vector3(3., 0., 0.));
+
+  // Algorithms that pick their strategy by iterator category.
+  const auto found = std::lower_bound(const_cloud.begin(), const_cloud.end(), 3.,
+                                      [](const Vector3& point, double x) { return point.x() < x; });
+  EXPECT_EQ(found - const_cloud.begin(), 3);
+  std::reverse(cloud.begin(), cloud.end());
+  EXPECT_EQ(const_cloud[0], Vector3(4., 0., 0.));
+  EXPECT_EQ(const_cloud[4], Vector3(0., 0., 0.));
+}
+
+GTEST_TEST(PointCloudTest, OptionalAttributes) {
+  PointCloud cloud(2);
+  EXPECT_FALSE(cloud.hasIntensity());
+  EXPECT_FALSE(cloud.hasTimestamp());
+  cloud.enableIntensity();
+  cloud.intensity()[1] = 0.5f;
+  cloud.push_back(Vector3(1., 1., 1.));
+  EXPECT_TRUE(cloud.hasIntensity());
+  EXPECT_EQ(cloud.intensity()[1], 0.5f);
+  EXPECT_EQ(cloud.intensity()[2], 0.f);
+  EXPECT_TRUE(IsAligned(cloud.intensity()));
+
+  cloud.enableTimestamp();
+  cloud.timestamp()[2] = 12.5;
+  cloud.resize(4);
+  EXPECT_EQ(cloud.timestamp()[2], 12.5);
+  EXPECT_EQ(cloud.timestamp()[3], 0.);
+}
+
+GTEST_TEST(PointCloudTest, BulkTransform) {
+  const Isometry t{Vector3{1., -2., 3.}, Isometry::RotateAround(Vector3::kUnitZ, M_PI / 3.).rotation()};
+  PointCloud cloud;
+  cloud.enableIntensity();
+  for (int i = 0; i < 37; ++i) {
+    cloud.push_back(Vector3(0.5 * i, -1. * i, 2.));
+    cloud.intensity()[i] = i;
+  }
+  const PointCloud moved = cloud.transformed(t);
+  ASSERT_EQ(moved.size(), cloud.size());
+  EXPECT_TRUE(moved.hasIntensity());
+  for (size_t i = 0; i < cloud.size(); ++i) {
+    const Vector3 expected = t * static_cast<Vector3>(cloud[i]);
+    EXPECT_NEAR(moved.x()[i], expected.x(), kTolerance);
+    EXPECT_NEAR(moved.y()[i], expected.y(), kTolerance);
+    EXPECT_NEAR(moved.z()[i], expected.z(), kTolerance);
+    EXPECT_EQ(moved.intensity()[i], cloud.intensity()[i]);
+  }
+  cloud.transform(t);
+  for (size_t i = 0; i < cloud.size(); ++i) {
+    EXPECT_EQ(cloud.x()[i], moved.x()[i]);
+    EXPECT_EQ(cloud.y()[i], moved.y()[i]);
+    EXPECT_EQ(cloud.z()[i], moved.z()[i]);
+  }
+
+  PointCloudf float_cloud(9);
+  float_cloud[3] = Vector3f(1.f, 2.f, 3.f);
+  float_cloud.transform(Isometryf(t));
+  const Vector3 expected = t * Vector3(1., 2., 3.);
+  EXPECT_NEAR(float_cloud.x()[3], expected.x(), 1e-5);
+  EXPECT_NEAR(float_cloud.y()[3], expected.y(), 1e-5);
+  EXPECT_NEAR(float_cloud.z()[3], expected.z(), 1e-5);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace math
+}  // namespace ekumen
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,121 @@
+#include "pose_slot.h"
+
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace ekumen {
+namespace math {
+namespace test {
+namespace {
+
+// Poses whose index can be recovered from the translation, so that a reader can tell which
+// pose it got and compare every element against it.
+std::vector<Isometry> MakePoses(const size_t count) {
+  std::vector<Isometry> poses;
+  for (size_t i = 0; i < count; ++i) {
+    poses.push_back(Isometry::FromTranslation(Vector3{static_cast<double>(i), -0.5 * i, 2. * i}) *
+                    Isometry::RotateAround(Vector3(1., 2., 3.) / Vector3(1., 2., 3.).norm(), 0.1 * i));
+  }
+  return poses;
+}
+
+bool AreIdentical(const Isometry& isometry1, const Isometry& isometry2) {
+  for (int i = 0; i < 3; ++i) {
+    if (isometry1.translation()[i] != isometry2.translation()[i]) {
+      return false;
+    }
+    for (uint32_t j = 0; j < 3; ++j) {
+      if (isometry1.rotation()[j][i] != isometry2.rotation()[j][i]) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+GTEST_TEST(PoseSlotTest, PublishAndRead) {
+  PoseSlot slot;
+  EXPECT_EQ(slot.version(), 0u);
+  EXPECT_TRUE(AreIdentical(slot.read(), Isometry::FromTranslation(Vector3::kZero)));
+
+  const std::vector<Isometry> poses = MakePoses(3);
+  const PoseSlot initialized(poses[2]);
+  EXPECT_TRUE(AreIdentical(initialized.read(), poses[2]));
+  EXPECT_EQ(initialized.version(), 0u);
+
+  for (size_t i = 0; i < poses.size(); ++i) {
+    slot.publish(poses[i]);
+    uint64_t version{0};
+    // Values round-trip bit for bit.
+    EXPECT_TRUE(AreIdentical(slot.read(&version), poses[i]));
+    EXPECT_EQ(version, i + 1);
+    EXPECT_EQ(slot.version(), i + 1);
+  }
+}
+
+// Readers must only ever observe poses that were published as a whole, with versions that
+// never go backwards, while writers keep replacing them.
+GTEST_TEST(PoseSlotTest, ConcurrentReadersSeeConsistentSnapshots) {
+  constexpr size_t kPoses{64};
+  constexpr int kReaders{8};
+  constexpr int kWriters{2};
+  constexpr uint64_t kPublishesPerWriter{20000};
+  const std::vector<Isometry> poses = MakePoses(kPoses);
+  PoseSlot slot(poses[0]);
+
+  std::atomic<bool> done{false};
+  std::atomic<uint64_t> torn_reads{0};
+  std::atomic<uint64_t> reads{0};
+  std::vector<std::thread> threads;
+  for (int reader = 0; reader < kReaders; ++reader) {
+    threads.emplace_back([&]() {
+      uint64_t last_version{0};
+      uint64_t local_reads{0};
+      while (!done.load(std::memory_order_acquire) || local_reads == 0) {
+        uint64_t version{0};
+        const Isometry pose = slot.read(&version);
+        const double index = pose.translation().x();
+        if (index < 0. || index >= kPoses || index != std::floor(index) ||
+            !AreIdentical(pose, poses[static_cast<size_t>(index)]) || version < last_version) {
+          torn_reads.fetch_add(1, std::memory_order_relaxed);
+        }
+        last_version = version;
+        ++local_reads;
+      }
+      reads.fetch_add(local_reads, std::memory_order_relaxed);
+    });
+  }
+  std::vector<std::thread> writers;
+  for (int writer = 0; writer < kWriters; ++writer) {
+    writers.emplace_back([&, writer]() {
+      for (uint64_t i = 0; i < kPublishesPerWriter; ++i) {
+        slot.publish(poses[(i * (writer + 1)) % kPoses]);
+      }
+    });
+  }
+  for (std::thread& writer : writers) {
+    writer.join();
+  }
+  done.store(true, std::memory_order_release);
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(torn_reads.load(), 0u);
+  EXPECT_GE(reads.load(), static_cast<uint64_t>(kReaders));
+  EXPECT_EQ(slot.version(), kWriters * kPublishesPerWriter);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace math
+}  // namespace ekumen
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,140 @@
+#include "quaternion.h"
+
+#include <cmath>
+#include <sstream>
+
+#include "gtest/gtest.h"
+
+namespace ekumen {
+namespace math {
+namespace test {
+namespace {
+
+testing::AssertionResult areAlmostEqual(const Matrix3& matrix1, const Matrix3& matrix2, const double tolerance) {
+  for (int i = 0; i < 3; ++i) {
+    for (int j = 0; j < 3; ++j) {
+      if (std::abs(matrix1[i][j] - matrix2[i][j]) > tolerance) {
+        return testing::AssertionFailure() << "The matrices differ at (" << i << ", " << j << ")";
+      }
+    }
+  }
+  return testing::AssertionSuccess();
+}
+
+testing::AssertionResult areAlmostEqual(const Vector3& vector1, const Vector3& vector2, const double tolerance) {
+  if (std::abs(vector1.x() - vector2.x()) > tolerance || std::abs(vector1.y() - vector2.y()) > tolerance ||
+      std::abs(vector1.z() - vector2.z()) > tolerance) {
+    return testing::AssertionFailure() << vector1 << " is not almost equal to " << vector2;
+  }
+  return testing::AssertionSuccess();
+}
+
+testing::AssertionResult areAlmostEqual(const Isometry& isometry1, const Isometry& isometry2, const double tolerance) {
+  if (!areAlmostEqual(isometry1.translation(), isometry2.translation(), tolerance) ||
+      !areAlmostEqual(isometry1.rotation(), isometry2.rotation(), tolerance)) {
+    return testing::AssertionFailure() << "The isometries are not almost equal";
+  }
+  return testing::AssertionSuccess();
+}
+
+GTEST_TEST(QuaternionTest, QuaternionOperations) {
+  const double kTolerance{1e-12};
+  const Quaternion identity;
+  EXPECT_EQ(identity, Quaternion(1., 0., 0., 0.));
+  EXPECT_TRUE(areAlmostEqual(identity.toMatrix(), Matrix3::kIdentity, kTolerance));
+
+  const Quaternion q{1., 2., 3., 4.};
+  EXPECT_NEAR(q.norm(), std::sqrt(30.), kTolerance);
+  EXPECT_NEAR(q.normalized().norm(), 1., kTolerance);
+  EXPECT_EQ(q.conjugate(), Quaternion(1., -2., -3., -4.));
+  EXPECT_EQ(q * Quaternion(5., 6., 7., 8.), Quaternion(-60., 12., 30., 24.));
+  EXPECT_NEAR(q.dot(q), 30., kTolerance);
+
+  std::stringstream ss;
+  ss << q;
+  EXPECT_EQ(ss.str(), "(w: 1, x: 2, y: 3, z: 4)");
+}
+
+GTEST_TEST(QuaternionTest, MatrixConversions) {
+  const double kTolerance{1e-12};
+  const Vector3 axes[]{Vector3::kUnitX, Vector3::kUnitY, Vector3::kUnitZ, Vector3(1., -2., 0.5)};
+  const double angles[]{0., 0.1, M_PI / 2., 2., M_PI - 1e-9, M_PI};
+  for (const Vector3& axis : axes) {
+    const Vector3 unit = axis / axis.norm();
+    for (const double angle : angles) {
+      const Quaternion q = Quaternion::FromAxisAngle(axis, angle);
+      const Matrix3 rotation = Isometry::RotateAround(unit, angle).rotation();
+      EXPECT_TRUE(areAlmostEqual(q.toMatrix(), rotation, kTolerance));
+      // FromMatrix may return -q, which is the same rotation.
+      const Quaternion back = Quaternion::FromMatrix(rotation);
+      EXPECT_NEAR(std::abs(back.dot(q)), 1., kTolerance);
+      EXPECT_TRUE(areAlmostEqual(back.toMatrix(), rotation, kTolerance));
+
+      const Vector3 p{0.3, -4., 2.};
+      EXPECT_TRUE(areAlmostEqual(q.rotate(p), rotation * p, kTolerance));
+    }
+  }
+}
+
+GTEST_TEST(QuaternionTest, Slerp) {
+  const double kTolerance{1e-12};
+  const Vector3 axis{1., 2., -0.5};
+  const Quaternion from = Quaternion::FromAxisAngle(axis, 0.2);
+  const Quaternion to = Quaternion::FromAxisAngle(axis, 1.4);
+  EXPECT_NEAR(Quaternion::Slerp(from, to, 0.).dot(from), 1., kTolerance);
+  EXPECT_NEAR(Quaternion::Slerp(from, to, 1.).dot(to), 1., kTolerance);
+  // About a fixed axis, slerp interpolates the angle linearly.
+  for (const double t : {0.1, 0.25, 0.5, 0.9}) {
+    const Quaternion expected = Quaternion::FromAxisAngle(axis, 0.2 + t * 1.2);
+    EXPECT_NEAR(Quaternion::Slerp(from, to, t).dot(expected), 1., kTolerance);
+  }
+  // -to is the same rotation, so the shortest arc is taken regardless of sign.
+  const Quaternion negated(-to.w(), -to.x(), -to.y(), -to.z());
+  EXPECT_NEAR(std::abs(Quaternion::Slerp(from, negated, 0.5).dot(Quaternion::FromAxisAngle(axis, 0.8))), 1.,
+              kTolerance);
+  // Nearly identical inputs take the normalized lerp path and stay unit length.
+  const Quaternion close = Quaternion::FromAxisAngle(axis, 0.2 + 1e-7);
+  EXPECT_NEAR(Quaternion::Slerp(from, close, 0.5).norm(), 1., kTolerance);
+  EXPECT_NEAR(Quaternion::Slerp(from, close, 0.5).dot(Quaternion::FromAxisAngle(axis, 0.2 + 5e-8)), 1., kTolerance);
+}
+
+GTEST_TEST(QuaternionIsometryTest, MatchesIsometry) {
+  const double kTolerance{1e-12};
+  const Isometry t1{Vector3{1., -2., 3.}, Isometry::FromEulerAngles(M_PI / 3., -M_PI / 5., M_PI / 7.).rotation()};
+  const Isometry t2{Vector3{-0.5, 4., 1.}, Isometry::RotateAround(Vector3::kUnitY, 2.5).rotation()};
+  const QuaternionIsometry q1{t1};
+  const QuaternionIsometry q2{t2};
+  const Vector3 p{4., 5., 6.};
+
+  EXPECT_TRUE(areAlmostEqual(q1.toIsometry(), t1, kTolerance));
+  EXPECT_TRUE(areAlmostEqual(q1 * p, t1 * p, kTolerance));
+  EXPECT_TRUE(areAlmostEqual(q1.transform(p), t1.transform(p), kTolerance));
+  EXPECT_TRUE(areAlmostEqual((q1 * q2).toIsometry(), t1 * t2, kTolerance));
+  EXPECT_TRUE(areAlmostEqual(q1.compose(q2).toIsometry(), t1.compose(t2), kTolerance));
+  EXPECT_TRUE(areAlmostEqual(q1.inverse().toIsometry(), t1.inverse(), kTolerance));
+  EXPECT_TRUE(areAlmostEqual((q1 * q1.inverse()).toIsometry(), Isometry(Matrix3::kIdentity), kTolerance));
+}
+
+GTEST_TEST(QuaternionIsometryTest, NormalizeBoundsDrift) {
+  const QuaternionIsometry step{Vector3{0.01, 0., 0.}, Quaternion::FromAxisAngle(Vector3(1., 2., 3.), 0.001)};
+  QuaternionIsometry pose;
+  for (int i = 0; i < 100000; ++i) {
+    pose = pose * step;
+    if (i % 1000 == 0) {
+      pose.normalize();
+    }
+  }
+  pose.normalize();
+  EXPECT_NEAR(pose.rotation().norm(), 1., 1e-15);
+  EXPECT_TRUE(pose.toIsometry().rotation().isOrthonormal(1e-12));
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace math
+}  // namespace ekumen
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,232 @@
+#include "svd.h"
+
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "isometry.h"
+
+#include "gtest/gtest.h"
+
+namespace ekumen {
+namespace math {
+namespace test {
+namespace {
+
+template <class T>
+T FrobeniusNorm(const Matrix3T<T>& matrix) {
+  return std::sqrt(matrix.r1().dot(matrix.r1()) + matrix.r2().dot(matrix.r2()) + matrix.r3().dot(matrix.r3()));
+}
+
+template <class T>
+Matrix3T<T> Diagonal(const Vector3T<T>& values) {
+  return Matrix3T<T>(Vector3T<T>(values.x(), 0, 0), Vector3T<T>(0, values.y(), 0), Vector3T<T>(0, 0, values.z()));
+}
+
+template <class T>
+testing::AssertionResult IsRotation(const Matrix3T<T>& matrix, const T tolerance) {
+  const Matrix3T<T> gram = matrix.transpose().product(matrix);
+  for (uint32_t row = 0; row < 3; ++row) {
+    for (int column = 0; column < 3; ++column) {
+      const T expected = row == static_cast<uint32_t>(column) ? T(1) : T(0);
+      if (std::fabs(gram[row][column] - expected) > tolerance) {
+        return testing::AssertionFailure() << matrix << " is not orthonormal";
+      }
+    }
+  }
+  if (matrix.det() < 0) {
+    return testing::AssertionFailure() << matrix << " is a reflection";
+  }
+  return testing::AssertionSuccess();
+}
+
+template <class T>
+testing::AssertionResult AreIdentical(const Matrix3T<T>& a, const Matrix3T<T>& b) {
+  for (uint32_t row = 0; row < 3; ++row) {
+    for (int column = 0; column < 3; ++column) {
+      if (a[row][column] != b[row][column]) {
+        return testing::AssertionFailure() << a << " != " << b;
+      }
+    }
+  }
+  return testing::AssertionSuccess();
+}
+
+// General, reflecting, rank deficient and nearly orthonormal matrices.
+template <class T>
+std::vector<Matrix3T<T>> RandomMatrices(size_t count, unsigned seed) {
+  std::mt19937 generator(seed);
+  std::uniform_real_distribution<T> element(-2., 2.);
+  std::uniform_real_distribution<T> angle(-3., 3.);
+  std::vector<Matrix3T<T>> matrices;
+  for (size_t i = 0; i < count; ++i) {
+    Matrix3T<T> matrix;
+    for (uint32_t row = 0; row < 3; ++row) {
+      matrix[row] = Vector3T<T>(element(generator), element(generator), element(generator));
+    }
+    switch (i % 4) {
+      case 1:
+        matrix[2] = matrix[0] * T(0.5) - matrix[1];
+        break;
+      case 2:
+        matrix = IsometryT<T>::FromEulerAngles(angle(generator), angle(generator), angle(generator)).rotation() +
+                 matrix * T(1e-4);
+        break;
+      default:
+        break;
+    }
+    matrices.push_back(matrix);
+  }
+  return matrices;
+}
+
+template <class T>
+void ExpectValidSvd() {
+  const T eps = std::numeric_limits<T>::epsilon();
+  for (const Matrix3T<T>& matrix : RandomMatrices<T>(10000, 17)) {
+    const SvdT<T> svd = ComputeSvd(matrix);
+    ASSERT_TRUE(IsRotation(svd.u, 16 * eps));
+    ASSERT_TRUE(IsRotation(svd.v, 16 * eps));
+    EXPECT_GE(svd.values.x(), svd.values.y());
+    EXPECT_GE(svd.values.y(), std::fabs(svd.values.z()));
+    const Matrix3T<T> product = svd.u.product(Diagonal(svd.values)).product(svd.v.transpose());
+    ASSERT_LE(FrobeniusNorm(Matrix3T<T>(product - matrix)), 16 * eps * FrobeniusNorm(matrix)) << matrix;
+  }
+}
+
+GTEST_TEST(SvdTest, DiagonalMatrix) {
+  const Svd svd = ComputeSvd(Diagonal(Vector3(1., 3., -2.)));
+  // det < 0, so the smallest singular value is negative.
+  EXPECT_EQ(svd.values, Vector3(3., 2., -1.));
+  EXPECT_TRUE(IsRotation(svd.u, 1e-15));
+  EXPECT_TRUE(IsRotation(svd.v, 1e-15));
+
+  const Svd zero = ComputeSvd(Matrix3::kZero);
+  EXPECT_EQ(zero.values, Vector3::kZero);
+  EXPECT_TRUE(IsRotation(zero.u, 1e-15));
+  EXPECT_TRUE(IsRotation(zero.v, 1e-15));
+}
+
+GTEST_TEST(SvdTest, Reconstruction) {
+  ExpectValidSvd<double>();
+  ExpectValidSvd<float>();
+}
+
+template <class T>
+void ExpectBatchMatchesSingle() {
+  // Not a multiple of the lane group, so the tail runs one matrix at a time.
+  const std::vector<Matrix3T<T>> matrices = RandomMatrices<T>(203, 23);
+  std::vector<SvdT<T>> results(matrices.size());
+  ComputeSvdBatch(matrices.data(), results.data(), matrices.size());
+  for (size_t i = 0; i < matrices.size(); ++i) {
+    const SvdT<T> expected = ComputeSvd(matrices[i]);
+    ASSERT_TRUE(AreIdentical(results[i].u, expected.u)) << "Matrix " << i;
+    ASSERT_TRUE(AreIdentical(results[i].v, expected.v)) << "Matrix " << i;
+    ASSERT_EQ(results[i].values.x(), expected.values.x());
+    ASSERT_EQ(results[i].values.y(), expected.values.y());
+    ASSERT_EQ(results[i].values.z(), expected.values.z());
+  }
+}
+
+GTEST_TEST(SvdTest, BatchMatchesSingle) {
+  ExpectBatchMatchesSingle<double>();
+  ExpectBatchMatchesSingle<float>();
+}
+
+// The matrices scaled by 2^exponent, near the ends of the range of T, still decompose within
+// the bounds of ExpectValidSvd() once the singular values are scaled back, and the batch still
+// matches single calls.
+template <class T>
+void ExpectValidAtScale(const int exponent) {
+  const T eps = std::numeric_limits<T>::epsilon();
+  std::vector<Matrix3T<T>> matrices;
+  for (const Matrix3T<T>& matrix : RandomMatrices<T>(2000, 29)) {
+    Matrix3T<T> scaled;
+    for (uint32_t row = 0; row < 3; ++row) {
+      for (int column = 0; column < 3; ++column) {
+        scaled[row][column] = std::ldexp(matrix[row][column], exponent);
+      }
+    }
+    matrices.push_back(scaled);
+  }
+  std::vector<SvdT<T>> results(matrices.size());
+  ComputeSvdBatch(matrices.data(), results.data(), matrices.size());
+  for (size_t i = 0; i < matrices.size(); ++i) {
+    const SvdT<T> svd = ComputeSvd(matrices[i]);
+    ASSERT_TRUE(AreIdentical(results[i].u, svd.u)) << "Matrix " << i << " scaled by 2^" << exponent;
+    ASSERT_TRUE(AreIdentical(results[i].v, svd.v)) << "Matrix " << i << " scaled by 2^" << exponent;
+    ASSERT_EQ(results[i].values.x(), svd.values.x());
+    ASSERT_EQ(results[i].values.y(), svd.values.y());
+    ASSERT_EQ(results[i].values.z(), svd.values.z());
+    ASSERT_TRUE(IsRotation(svd.u, 16 * eps));
+    ASSERT_TRUE(IsRotation(svd.v, 16 * eps));
+    Matrix3T<T> matrix;
+    for (uint32_t row = 0; row < 3; ++row) {
+      for (int column = 0; column < 3; ++column) {
+        matrix[row][column] = std::ldexp(matrices[i][row][column], -exponent);
+      }
+    }
+    const Vector3T<T> values(std::ldexp(svd.values.x(), -exponent), std::ldexp(svd.values.y(), -exponent),
+                             std::ldexp(svd.values.z(), -exponent));
+    const Matrix3T<T> product = svd.u.product(Diagonal(values)).product(svd.v.transpose());
+    ASSERT_LE(FrobeniusNorm(Matrix3T<T>(product - matrix)), 16 * eps * FrobeniusNorm(matrix))
+        << matrix << " scaled by 2^" << exponent;
+  }
+}
+
+GTEST_TEST(SvdTest, ExtremeScales) {
+  for (const int exponent : {-1000, -600, 600, 1000}) {
+    ExpectValidAtScale<double>(exponent);
+  }
+  for (const int exponent : {-120, -70, 70, 100}) {
+    ExpectValidAtScale<float>(exponent);
+  }
+}
+
+GTEST_TEST(SvdTest, PolarDecomposition) {
+  const Matrix3 rotation = Isometry::FromEulerAngles(0.3, -1.2, 2.5).rotation();
+  const Matrix3 stretch{2., 0.5, 0.1, 0.5, 1., -0.2, 0.1, -0.2, 3.};
+  const Polar polar = PolarDecompose(rotation.product(stretch));
+  EXPECT_TRUE(IsRotation(polar.rotation, 1e-14));
+  for (uint32_t row = 0; row < 3; ++row) {
+    for (int column = 0; column < 3; ++column) {
+      EXPECT_NEAR(polar.rotation[row][column], rotation[row][column], 1e-14);
+      EXPECT_NEAR(polar.stretch[row][column], stretch[row][column], 1e-14);
+    }
+  }
+
+  // A reflection still yields a proper rotation, with an indefinite stretch.
+  const Matrix3 mirrored = rotation.product(Diagonal(Vector3(1., 1., -1.)));
+  const Polarf polar_float = PolarDecompose(Matrix3f(mirrored));
+  EXPECT_TRUE(IsRotation(polar_float.rotation, 1e-6f));
+  EXPECT_LT(polar_float.stretch.det(), 0.f);
+}
+
+GTEST_TEST(SvdTest, NearestRotation) {
+  const Matrix3 rotation = Isometry::RotateAround(Vector3(1., 2., 2.) / 3., 0.7).rotation();
+  const Matrix3 nearest = NearestRotation(rotation);
+  for (uint32_t row = 0; row < 3; ++row) {
+    for (int column = 0; column < 3; ++column) {
+      EXPECT_NEAR(nearest[row][column], rotation[row][column], 1e-15);
+    }
+  }
+
+  // Drifted off SO(3): the projection is orthonormal again and moves it about as far as the
+  // drift did.
+  const Matrix3 drifted = rotation + Matrix3{1., -2., 0.5, 0.3, 2., -1., -0.7, 0.2, 1.} * 1e-5;
+  EXPECT_FALSE(drifted.isOrthonormal(1e-6));
+  const Matrix3 projected = NearestRotation(drifted);
+  EXPECT_TRUE(projected.isOrthonormal(1e-15));
+  EXPECT_LT(FrobeniusNorm(Matrix3(projected - rotation)), 5e-5);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace math
+}  // namespace ekumen
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,229 @@
+#include "symmetric_eigen.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "isometry.h"
+
+#include "gtest/gtest.h"
+
+namespace ekumen {
+namespace math {
+namespace test {
+namespace {
+
+template <class T>
+T FrobeniusNorm(const Matrix3T<T>& matrix) {
+  return std::sqrt(matrix.r1().dot(matrix.r1()) + matrix.r2().dot(matrix.r2()) + matrix.r3().dot(matrix.r3()));
+}
+
+// Exact equality, element by element. Batches may differ from single calls only in the sign
+// of zeros.
+template <class T>
+testing::AssertionResult AreIdentical(const EigenDecompositionT<T>& a, const EigenDecompositionT<T>& b) {
+  for (int i = 0; i < 3; ++i) {
+    if (a.values[i] != b.values[i]) {
+      return testing::AssertionFailure() << "Eigenvalue " << i << " differs";
+    }
+    for (uint32_t row = 0; row < 3; ++row) {
+      if (a.vectors[row][i] != b.vectors[row][i]) {
+        return testing::AssertionFailure() << "Eigenvector " << i << " differs";
+      }
+    }
+  }
+  return testing::AssertionSuccess();
+}
+
+// Symmetric matrices R * diag(values) * R^T with known eigenvalues, built in double.
+struct Case {
+  Matrix3 matrix;
+  Vector3 values;
+};
+
+std::vector<Case> RandomCases(size_t count, unsigned seed) {
+  std::mt19937 generator(seed);
+  std::uniform_real_distribution<double> angle(-M_PI, M_PI);
+  std::uniform_real_distribution<double> value(-1., 1.);
+  std::uniform_int_distribution<int> kind(0, 3);
+  std::vector<Case> cases;
+  for (size_t i = 0; i < count; ++i) {
+    double values[3]{value(generator), value(generator), value(generator)};
+    switch (kind(generator)) {
+      case 0:
+        // Plane covariance: one zero eigenvalue.
+        values[0] = 0.;
+        values[1] = std::fabs(values[1]);
+        values[2] = std::fabs(values[2]);
+        break;
+      case 1:
+        // Repeated eigenvalue.
+        values[1] = values[0];
+        break;
+      case 2:
+        // Wide dynamic range.
+        values[0] *= 1e-8;
+        values[1] *= 1e-4;
+        break;
+      default:
+        break;
+    }
+    const Matrix3 rotation =
+        Isometry::FromEulerAngles(angle(generator), angle(generator), angle(generator)).rotation();
+    const Matrix3 diagonal{values[0], 0., 0., 0., values[1], 0., 0., 0., values[2]};
+    std::sort(values, values + 3);
+    cases.push_back(Case{rotation.product(diagonal).product(rotation.transpose()), Vector3(values[0], values[1], values[2])});
+  }
+  return cases;
+}
+
+// Checks the accuracy envelope documented in symmetric_eigen.h.
+template <class T>
+void ExpectWithinEnvelope(const Matrix3T<T>& matrix, const Vector3& expected_values,
+                          const EigenDecompositionT<T>& result) {
+  const double bound = 8. * std::numeric_limits<T>::epsilon() * FrobeniusNorm(Matrix3(matrix));
+  const Matrix3 vectors(result.vectors);
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_NEAR(result.values[i], expected_values[i], bound);
+    const Vector3 v = vectors.col(i);
+    const Vector3 residual = Matrix3(matrix) * v - v * static_cast<double>(result.values[i]);
+    EXPECT_LE(residual.norm(), bound);
+  }
+  const Matrix3 gram = vectors.transpose().product(vectors);
+  for (uint32_t row = 0; row < 3; ++row) {
+    for (int column = 0; column < 3; ++column) {
+      EXPECT_NEAR(gram[row][column], row == static_cast<uint32_t>(column) ? 1. : 0.,
+                  8. * std::numeric_limits<T>::epsilon());
+    }
+  }
+  EXPECT_GT(vectors.det(), 0.);
+}
+
+GTEST_TEST(SymmetricEigenTest, DiagonalMatrix) {
+  const Matrix3 matrix{3., 0., 0., 0., -1., 0., 0., 0., 2.};
+  const EigenDecomposition result = EigenDecompose(matrix);
+  EXPECT_EQ(result.values, Vector3(-1., 2., 3.));
+  EXPECT_EQ(result.vectors.col(0), Vector3(0., 1., 0.));
+  EXPECT_EQ(result.vectors.col(1), Vector3(0., 0., 1.));
+  // The third column is flipped if needed to make the basis right handed.
+  EXPECT_EQ(result.vectors.col(2), Vector3(1., 0., 0.));
+  EXPECT_NEAR(result.vectors.det(), 1., 1e-15);
+
+  const EigenDecomposition zero = EigenDecompose(Matrix3::kZero);
+  EXPECT_EQ(zero.values, Vector3::kZero);
+  EXPECT_EQ(zero.vectors, Matrix3::kIdentity);
+}
+
+GTEST_TEST(SymmetricEigenTest, ReadsUpperTriangle) {
+  const Matrix3 symmetric{2., 1., 0., 1., 2., 0., 0., 0., 5.};
+  Matrix3 upper{symmetric};
+  upper[1][0] = 100.;
+  upper[2][1] = -7.;
+  const EigenDecomposition expected = EigenDecompose(symmetric);
+  const EigenDecomposition result = EigenDecompose(upper);
+  EXPECT_EQ(result.values, expected.values);
+  EXPECT_EQ(result.vectors, expected.vectors);
+  EXPECT_NEAR(result.values[0], 1., 1e-15);
+  EXPECT_NEAR(result.values[1], 3., 1e-15);
+  EXPECT_NEAR(result.values[2], 5., 1e-15);
+}
+
+GTEST_TEST(SymmetricEigenTest, AccuracyEnvelope) {
+  for (const Case& c : RandomCases(20000, 5)) {
+    ExpectWithinEnvelope(c.matrix, c.values, EigenDecompose(c.matrix));
+    ExpectWithinEnvelope(Matrix3f(c.matrix), c.values, EigenDecompose(Matrix3f(c.matrix)));
+    if (HasFailure()) {
+      FAIL() << "Matrix " << c.matrix << " with eigenvalues " << c.values;
+    }
+  }
+}
+
+// Scaling by a power of two is exact, so the eigenvalues of the scaled matrix, scaled back,
+// must meet the envelope of the original one. Squares of the elements overflow or flush to
+// zero at these scales.
+template <class T>
+void ExpectScaleInvariant(const int exponent) {
+  for (const Case& c : RandomCases(2000, 7)) {
+    const Matrix3T<T> matrix(c.matrix);
+    Matrix3T<T> scaled;
+    for (uint32_t row = 0; row < 3; ++row) {
+      for (int column = 0; column < 3; ++column) {
+        scaled[row][column] = std::ldexp(matrix[row][column], exponent);
+      }
+    }
+    EigenDecompositionT<T> result = EigenDecompose(scaled);
+    for (int i = 0; i < 3; ++i) {
+      result.values[i] = std::ldexp(result.values[i], -exponent);
+    }
+    ExpectWithinEnvelope(matrix, c.values, result);
+    if (::testing::Test::HasFailure()) {
+      FAIL() << "Matrix " << c.matrix << " scaled by 2^" << exponent;
+    }
+  }
+}
+
+GTEST_TEST(SymmetricEigenTest, ExtremeScales) {
+  // Each call stops at its first failing case, so stop at the first failing scale too.
+  for (const int exponent : {-900, -660, 660, 1000}) {
+    ExpectScaleInvariant<double>(exponent);
+    if (HasFailure()) {
+      return;
+    }
+  }
+  for (const int exponent : {-90, 100}) {
+    ExpectScaleInvariant<float>(exponent);
+    if (HasFailure()) {
+      return;
+    }
+  }
+}
+
+GTEST_TEST(SymmetricEigenTest, PlaneNormal) {
+  // Covariance of points scattered on the plane through the origin with normal |normal|.
+  const Vector3 normal = Vector3(1., -2., 0.5) / Vector3(1., -2., 0.5).norm();
+  const Vector3 u = normal.cross(Vector3::kUnitZ) / normal.cross(Vector3::kUnitZ).norm();
+  const Vector3 w = normal.cross(u);
+  std::mt19937 generator(3);
+  std::normal_distribution<double> distribution(0., 1.);
+  Matrix3 covariance;
+  for (int i = 0; i < 100; ++i) {
+    const Vector3 point = u * (2. * distribution(generator)) + w * distribution(generator);
+    for (uint32_t row = 0; row < 3; ++row) {
+      covariance[row] += point * point[row];
+    }
+  }
+  const EigenDecomposition result = EigenDecompose(covariance);
+  EXPECT_NEAR(result.values[0], 0., 1e-12);
+  EXPECT_NEAR(std::fabs(result.vectors.col(0).dot(normal)), 1., 1e-12);
+}
+
+GTEST_TEST(SymmetricEigenTest, BatchMatchesSingle) {
+  std::vector<Matrix3> matrices;
+  for (const Case& c : RandomCases(1000, 9)) {
+    matrices.push_back(c.matrix);
+  }
+  std::vector<EigenDecomposition> results(matrices.size());
+  EigenDecomposeBatch(matrices.data(), results.data(), matrices.size());
+  for (size_t i = 0; i < matrices.size(); ++i) {
+    ASSERT_TRUE(AreIdentical(results[i], EigenDecompose(matrices[i]))) << "Matrix " << i;
+  }
+
+  std::vector<Matrix3f> matrices_float(matrices.begin(), matrices.end());
+  std::vector<EigenDecompositionf> results_float(matrices.size());
+  EigenDecomposeBatch(matrices_float.data(), results_float.data(), matrices_float.size());
+  for (size_t i = 0; i < matrices_float.size(); ++i) {
+    ASSERT_TRUE(AreIdentical(results_float[i], EigenDecompose(matrices_float[i]))) << "Matrix " << i;
+  }
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace math
+}  // namespace ekumen
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
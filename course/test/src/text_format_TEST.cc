@@ -0,0 +1,258 @@
+#include "text_format.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <string>
+#include <type_traits>
+
+#include "isometry.h"
+
+#include "gtest/gtest.h"
+
+namespace ekumen {
+namespace math {
+namespace test {
+namespace {
+
+template <class T>
+std::string FormatToString(const T& value) {
+  char buffer[kMaxIsometryChars];
+  return std::string(buffer, FormatScalar(value, buffer));
+}
+
+template <class T>
+bool SameBits(const T a, const T b) {
+  return std::memcmp(&a, &b, sizeof(T)) == 0;
+}
+
+// Significant digits of |text|, without leading or trailing zeros.
+std::string SignificantDigits(const std::string& text) {
+  std::string digits;
+  for (const char c : text.substr(0, text.find('e'))) {
+    if (c >= '0' && c <= '9' && (c != '0' || !digits.empty())) {
+      digits += c;
+    }
+  }
+  return digits.substr(0, digits.find_last_not_of('0') + 1);
+}
+
+// Significant digits of the "%.*e" text with the fewest digits that reads back as |value|
+// through strtod or strtof, the slow but obviously correct way to find the shortest and
+// closest representation.
+template <class T>
+std::string ShortestPrintfDigits(const T value) {
+  constexpr int kMaxDigits{std::numeric_limits<T>::max_digits10};
+  char text[64];
+  for (int precision = 1; precision <= kMaxDigits; ++precision) {
+    std::snprintf(text, sizeof(text), "%.*e", precision - 1, static_cast<double>(value));
+    const double parsed = std::is_same<T, float>::value ? std::strtof(text, nullptr) : std::strtod(text, nullptr);
+    if (parsed == value) {
+      break;
+    }
+  }
+  return SignificantDigits(text);
+}
+
+GTEST_TEST(TextFormatTest, FormatsScalars) {
+  EXPECT_EQ(FormatToString(0.), "0");
+  EXPECT_EQ(FormatToString(-0.), "-0");
+  EXPECT_EQ(FormatToString(1.), "1");
+  EXPECT_EQ(FormatToString(-2.25), "-2.25");
+  EXPECT_EQ(FormatToString(0.1), "0.1");
+  EXPECT_EQ(FormatToString(0.3), "0.3");
+  EXPECT_EQ(FormatToString(0.1 + 0.2), "0.30000000000000004");
+  EXPECT_EQ(FormatToString(1. / 3.), "0.3333333333333333");
+  EXPECT_EQ(FormatToString(123456.789), "123456.789");
+  EXPECT_EQ(FormatToString(100.), "100");
+  EXPECT_EQ(FormatToString(1e16), "10000000000000000");
+  EXPECT_EQ(FormatToString(1e17), "1e+17");
+  EXPECT_EQ(FormatToString(1e23), "1e+23");
+  EXPECT_EQ(FormatToString(0.01182376), "0.01182376");
+  EXPECT_EQ(FormatToString(5e-324 * 3), "1.5e-323");
+  EXPECT_EQ(FormatToString(0.001), "0.001");
+  EXPECT_EQ(FormatToString(1e-4), "0.0001");
+  EXPECT_EQ(FormatToString(1e-5), "1e-05");
+  EXPECT_EQ(FormatToString(-1.25e-100), "-1.25e-100");
+  EXPECT_EQ(FormatToString(std::numeric_limits<double>::max()), "1.7976931348623157e+308");
+  EXPECT_EQ(FormatToString(std::numeric_limits<double>::min()), "2.2250738585072014e-308");
+  EXPECT_EQ(FormatToString(std::numeric_limits<double>::denorm_min()), "5e-324");
+  EXPECT_EQ(FormatToString(std::numeric_limits<double>::infinity()), "inf");
+  EXPECT_EQ(FormatToString(-std::numeric_limits<double>::infinity()), "-inf");
+  EXPECT_EQ(FormatToString(std::numeric_limits<double>::quiet_NaN()), "nan");
+
+  EXPECT_EQ(FormatToString(0.1f), "0.1");
+  EXPECT_EQ(FormatToString(1.f / 3.f), "0.33333334");
+  EXPECT_EQ(FormatToString(std::numeric_limits<float>::max()), "3.4028235e+38");
+  EXPECT_EQ(FormatToString(std::numeric_limits<float>::denorm_min()), "1e-45");
+}
+
+GTEST_TEST(TextFormatTest, DoublesRoundTripThroughShortText) {
+  std::mt19937_64 generator(17);
+  for (int i = 0; i < 100000; ++i) {
+    const uint64_t bits = generator();
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    if (std::isnan(value)) {
+      continue;
+    }
+    const std::string text = FormatToString(value);
+    ASSERT_LE(text.size(), kMaxScalarChars);
+    double parsed;
+    ASSERT_EQ(ParseScalar(text.data(), text.data() + text.size(), &parsed), text.data() + text.size());
+    ASSERT_TRUE(SameBits(parsed, value)) << text;
+    // The C library agrees on the value.
+    ASSERT_TRUE(SameBits(std::strtod(text.c_str(), nullptr), value)) << text;
+    if (std::isfinite(value) && value != 0.) {
+      ASSERT_EQ(SignificantDigits(text), ShortestPrintfDigits(value)) << text;
+    }
+  }
+}
+
+GTEST_TEST(TextFormatTest, FloatsRoundTripThroughShortText) {
+  std::mt19937 generator(17);
+  for (int i = 0; i < 200000; ++i) {
+    const uint32_t bits = generator();
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    if (std::isnan(value)) {
+      continue;
+    }
+    const std::string text = FormatToString(value);
+    float parsed;
+    ASSERT_EQ(ParseScalar(text.data(), text.data() + text.size(), &parsed), text.data() + text.size());
+    ASSERT_TRUE(SameBits(parsed, value)) << text;
+    ASSERT_TRUE(SameBits(std::strtof(text.c_str(), nullptr), value)) << text;
+    if (std::isfinite(value) && value != 0.f) {
+      ASSERT_EQ(SignificantDigits(text), ShortestPrintfDigits(value)) << text;
+    }
+  }
+}
+
+GTEST_TEST(TextFormatTest, ParsesScalars) {
+  const auto parse = [](const std::string& text, double* value) -> long {
+    const char* end = ParseScalar(text.data(), text.data() + text.size(), value);
+    return end == nullptr ? -1 : end - text.data();
+  };
+  double value = 0.;
+  EXPECT_EQ(parse("  1.5e3", &value), 7);
+  EXPECT_EQ(value, 1500.);
+  EXPECT_EQ(parse("+.5", &value), 3);
+  EXPECT_EQ(value, 0.5);
+  EXPECT_EQ(parse("7.", &value), 2);
+  EXPECT_EQ(value, 7.);
+  EXPECT_EQ(parse("-0", &value), 2);
+  EXPECT_TRUE(SameBits(value, -0.));
+  EXPECT_EQ(parse("2E-2", &value), 4);
+  EXPECT_EQ(value, 0.02);
+  // Digits past the fast path go through the correctly rounded slow path.
+  EXPECT_EQ(parse("0.1000000000000000055511151231257827", &value), 36);
+  EXPECT_EQ(value, 0.1);
+  EXPECT_EQ(parse("123456789012345678901234567890", &value), 30);
+  EXPECT_EQ(value, 123456789012345678901234567890.);
+  EXPECT_EQ(parse("1e400", &value), 5);
+  EXPECT_EQ(value, std::numeric_limits<double>::infinity());
+  EXPECT_EQ(parse("1e-400", &value), 6);
+  EXPECT_EQ(value, 0.);
+  EXPECT_EQ(parse("-inf", &value), 4);
+  EXPECT_EQ(value, -std::numeric_limits<double>::infinity());
+  EXPECT_EQ(parse("nan", &value), 3);
+  EXPECT_TRUE(std::isnan(value));
+  // An exponent without digits is not part of the number.
+  EXPECT_EQ(parse("3e, 4", &value), 1);
+  EXPECT_EQ(value, 3.);
+  EXPECT_EQ(parse("0x10", &value), 1);
+  EXPECT_EQ(value, 0.);
+
+  value = 42.;
+  EXPECT_EQ(parse("", &value), -1);
+  EXPECT_EQ(parse("-", &value), -1);
+  EXPECT_EQ(parse(".", &value), -1);
+  EXPECT_EQ(parse("x", &value), -1);
+  EXPECT_EQ(value, 42.);
+}
+
+GTEST_TEST(TextFormatTest, FormatsMathTypes) {
+  const Isometry isometry{Vector3{1.5, -2., 1e-7}, Isometry::RotateAround(Vector3::kUnitZ, M_PI / 8.).rotation()};
+  char buffer[kMaxIsometryChars];
+  EXPECT_EQ(std::string(buffer, Format(isometry.translation(), buffer)), "(x: 1.5, y: -2, z: 1e-07)");
+  EXPECT_EQ(std::string(buffer, Format(Matrix3::kIdentity, buffer)), "[[1, 0, 0], [0, 1, 0], [0, 0, 1]]");
+  EXPECT_EQ(std::string(buffer, Format(isometry, buffer)),
+            "[T: (x: 1.5, y: -2, z: 1e-07), R:[[0.9238795325112867, -0.3826834323650898, 0], "
+            "[0.3826834323650898, 0.9238795325112867, 0], [0, 0, 1]]]");
+
+  // The stream operators print the same text.
+  std::stringstream ss;
+  ss << isometry;
+  EXPECT_EQ(ss.str(), std::string(buffer, Format(isometry, buffer)));
+}
+
+GTEST_TEST(TextFormatTest, MathTypesRoundTrip) {
+  std::mt19937_64 generator(5);
+  std::uniform_real_distribution<double> distribution(-100., 100.);
+  char buffer[kMaxIsometryChars];
+  for (int i = 0; i < 1000; ++i) {
+    const Isometry expected{Vector3{distribution(generator), distribution(generator), distribution(generator)},
+                            Isometry::FromEulerAngles(distribution(generator), distribution(generator),
+                                                      distribution(generator)).rotation()};
+    const char* end = Format(expected, buffer);
+    Isometry parsed = Isometry::FromTranslation(Vector3::kZero);
+    ASSERT_EQ(Parse(buffer, end, &parsed), end);
+    for (uint32_t row = 0; row < 3; ++row) {
+      ASSERT_TRUE(SameBits(parsed.translation()[row], expected.translation()[row]));
+      for (int column = 0; column < 3; ++column) {
+        ASSERT_TRUE(SameBits(parsed.rotation()[row][column], expected.rotation()[row][column]));
+      }
+    }
+  }
+
+  const Vector3f vector{0.1f, -3.f, 1e30f};
+  Vector3f parsed_vector;
+  const char* end = Format(vector, buffer);
+  ASSERT_EQ(Parse(buffer, end, &parsed_vector), end);
+  EXPECT_TRUE(SameBits(parsed_vector.x(), 0.1f));
+  EXPECT_TRUE(SameBits(parsed_vector.z(), 1e30f));
+}
+
+GTEST_TEST(TextFormatTest, ParsesFlexibleSpacing) {
+  const std::string text = "[ T:(x:1,y:2,z:3) ,R: [[1,0,0],[0, 1,0],[ 0,0,1 ] ] ]";
+  Isometry isometry = Isometry::FromTranslation(Vector3::kZero);
+  EXPECT_EQ(Parse(text.data(), text.data() + text.size(), &isometry), text.data() + text.size());
+  EXPECT_EQ(isometry.translation(), Vector3(1., 2., 3.));
+  EXPECT_EQ(isometry.rotation(), Matrix3::kIdentity);
+}
+
+GTEST_TEST(TextFormatTest, RejectsMalformedText) {
+  const auto parse_vector = [](const std::string& text, Vector3* vector) {
+    return Parse(text.data(), text.data() + text.size(), vector) != nullptr;
+  };
+  Vector3 vector{7., 8., 9.};
+  EXPECT_FALSE(parse_vector("(x: 1, y: 2)", &vector));
+  EXPECT_FALSE(parse_vector("(x: 1, y: 2, z: 3", &vector));
+  EXPECT_FALSE(parse_vector("(x: 1, z: 2, y: 3)", &vector));
+  EXPECT_FALSE(parse_vector("(x: 1, y: two, z: 3)", &vector));
+  EXPECT_EQ(vector, Vector3(7., 8., 9.));
+
+  Matrix3 matrix{Matrix3::kIdentity};
+  const std::string short_row = "[[1, 0], [0, 1, 0], [0, 0, 1]]";
+  EXPECT_EQ(Parse(short_row.data(), short_row.data() + short_row.size(), &matrix), nullptr);
+  EXPECT_EQ(matrix, Matrix3::kIdentity);
+
+  // A scaled rotation is not an isometry.
+  Isometry isometry = Isometry::FromTranslation(Vector3::kUnitX);
+  const std::string scaled = "[T: (x: 0, y: 0, z: 0), R:[[2, 0, 0], [0, 1, 0], [0, 0, 1]]]";
+  EXPECT_EQ(Parse(scaled.data(), scaled.data() + scaled.size(), &isometry), nullptr);
+  const std::string not_a_number = "[T: (x: 0, y: 0, z: 0), R:[[nan, 0, 0], [0, 1, 0], [0, 0, 1]]]";
+  EXPECT_EQ(Parse(not_a_number.data(), not_a_number.data() + not_a_number.size(), &isometry), nullptr);
+  EXPECT_EQ(isometry.translation(), Vector3::kUnitX);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace math
+}  // namespace ekumen
@@ -0,0 +1,91 @@
+#include "thread_pool.h"
+
+#include <atomic>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace ekumen {
+namespace math {
+namespace test {
+namespace {
+
+GTEST_TEST(ThreadPoolTest, RunsEveryIndexOnce) {
+  for (const size_t threads : {1u, 2u, 5u}) {
+    ThreadPool pool(threads);
+    EXPECT_EQ(pool.size(), threads);
+    for (const size_t count : {0u, 1u, 3u, 1000u}) {
+      std::vector<std::atomic<int>> hits(count);
+      for (std::atomic<int>& hit : hits) {
+        hit.store(0);
+      }
+      pool.parallelFor(count, [&hits](size_t i) { hits[i].fetch_add(1); });
+      for (size_t i = 0; i < count; ++i) {
+        EXPECT_EQ(hits[i].load(), 1) << "threads " << threads << ", index " << i;
+      }
+    }
+  }
+  ThreadPool default_pool;
+  EXPECT_GE(default_pool.size(), 1u);
+}
+
+GTEST_TEST(ThreadPoolTest, UnevenWorkIsShared) {
+  ThreadPool pool(4);
+  std::vector<long> sums(64, 0);
+  // Early indices are far more expensive than late ones, so idle workers have to steal.
+  pool.parallelFor(sums.size(), [&sums](size_t i) {
+    const long steps = i < 4 ? 2000000 : 1000;
+    long sum = 0;
+    for (long j = 0; j < steps; ++j) {
+      sum += j % 7;
+    }
+    sums[i] = sum;
+  });
+  for (size_t i = 0; i < sums.size(); ++i) {
+    const long steps = i < 4 ? 2000000 : 1000;
+    long expected = 0;
+    for (long j = 0; j < steps; ++j) {
+      expected += j % 7;
+    }
+    EXPECT_EQ(sums[i], expected);
+  }
+}
+
+GTEST_TEST(ThreadPoolTest, NestedCallsDoNotDeadlock) {
+  ThreadPool pool(2);
+  std::atomic<int> total{0};
+  pool.parallelFor(8, [&](size_t) {
+    pool.parallelFor(8, [&](size_t) { total.fetch_add(1); });
+  });
+  EXPECT_EQ(total.load(), 64);
+}
+
+GTEST_TEST(ThreadPoolTest, ExceptionsReachTheCaller) {
+  ThreadPool pool(3);
+  std::atomic<int> finished{0};
+  EXPECT_THROW(pool.parallelFor(100,
+                                [&finished](size_t i) {
+                                  if (i == 42) {
+                                    throw std::runtime_error("task failed");
+                                  }
+                                  finished.fetch_add(1);
+                                }),
+               std::runtime_error);
+  // The remaining tasks still ran, and the pool stays usable.
+  EXPECT_EQ(finished.load(), 99);
+  std::atomic<int> after{0};
+  pool.parallelFor(10, [&after](size_t) { after.fetch_add(1); });
+  EXPECT_EQ(after.load(), 10);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace math
+}  // namespace ekumen
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
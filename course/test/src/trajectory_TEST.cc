@@ -0,0 +1,89 @@
+#include "trajectory.h"
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace ekumen {
+namespace math {
+namespace test {
+namespace {
+
+testing::AssertionResult areAlmostEqual(const Isometry& isometry1, const Isometry& isometry2, const double tolerance) {
+  for (int i = 0; i < 3; ++i) {
+    if (std::abs(isometry1.translation()[i] - isometry2.translation()[i]) > tolerance) {
+      return testing::AssertionFailure() << "Translations differ: " << isometry1 << " vs " << isometry2;
+    }
+    for (uint32_t j = 0; j < 3; ++j) {
+      if (std::abs(isometry1.rotation()[j][i] - isometry2.rotation()[j][i]) > tolerance) {
+        return testing::AssertionFailure() << "Rotations differ: " << isometry1 << " vs " << isometry2;
+      }
+    }
+  }
+  return testing::AssertionSuccess();
+}
+
+// Odometry-like steps: short forward moves with small turns.
+std::vector<Isometry> RandomSteps(const size_t count) {
+  std::mt19937 generator(3);
+  std::uniform_real_distribution<double> distance(0., 0.05);
+  std::uniform_real_distribution<double> angle(-0.01, 0.01);
+  std::vector<Isometry> steps;
+  steps.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    steps.push_back(Isometry::FromTranslation(Vector3{distance(generator), 0., 0.01 * angle(generator)}) *
+                    Isometry::FromEulerAngles(angle(generator), angle(generator), angle(generator)));
+  }
+  return steps;
+}
+
+GTEST_TEST(TrajectoryTest, SerialMatchesManualChain) {
+  const std::vector<Isometry> steps = RandomSteps(50);
+  std::vector<Isometry> poses(steps.size(), Isometry::FromTranslation(Vector3::kZero));
+  PrefixCompose(steps.data(), poses.data(), steps.size());
+  Isometry expected = steps[0];
+  EXPECT_TRUE(areAlmostEqual(poses[0], expected, 0.));
+  for (size_t i = 1; i < steps.size(); ++i) {
+    expected = expected * steps[i];
+    EXPECT_TRUE(areAlmostEqual(poses[i], expected, 0.));
+  }
+  // Empty input is a no-op.
+  PrefixCompose(steps.data(), poses.data(), 0);
+}
+
+GTEST_TEST(TrajectoryTest, ParallelMatchesSerial) {
+  constexpr double kTolerance{1e-9};
+  for (const size_t threads : {1u, 2u, 3u, 8u}) {
+    ThreadPool pool(threads);
+    for (const size_t count : {0u, 1u, 2u, 7u, 33u, 20000u}) {
+      const std::vector<Isometry> steps = RandomSteps(count);
+      std::vector<Isometry> serial(count, Isometry::FromTranslation(Vector3::kZero));
+      std::vector<Isometry> parallel(serial);
+      PrefixCompose(steps.data(), serial.data(), count);
+      // Forces the parallel path even for tiny inputs.
+      PrefixCompose(pool, steps.data(), parallel.data(), count, 0);
+      for (size_t i = 0; i < count; ++i) {
+        ASSERT_TRUE(areAlmostEqual(parallel[i], serial[i], kTolerance))
+            << "threads " << threads << ", count " << count << ", index " << i;
+      }
+      // In place.
+      std::vector<Isometry> in_place(steps);
+      PrefixCompose(pool, in_place.data(), in_place.data(), count, 0);
+      for (size_t i = 0; i < count; ++i) {
+        ASSERT_TRUE(areAlmostEqual(in_place[i], serial[i], kTolerance));
+      }
+    }
+  }
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace math
+}  // namespace ekumen
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
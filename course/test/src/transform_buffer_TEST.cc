@@ -0,0 +1,115 @@
+#include "transform_buffer.h"
+
+#include <cmath>
+#include <stdexcept>
+
+#include "gtest/gtest.h"
+
+namespace ekumen {
+namespace math {
+namespace test {
+namespace {
+
+constexpr double kTolerance{1e-9};
+
+testing::AssertionResult areAlmostEqual(const Isometry& isometry1, const Isometry& isometry2, const double tolerance) {
+  for (int i = 0; i < 3; ++i) {
+    if (std::abs(isometry1.translation()[i] - isometry2.translation()[i]) > tolerance) {
+      return testing::AssertionFailure() << "Translations differ: " << isometry1 << " vs " << isometry2;
+    }
+    for (int j = 0; j < 3; ++j) {
+      if (std::abs(isometry1.rotation()[i][j] - isometry2.rotation()[i][j]) > tolerance) {
+        return testing::AssertionFailure() << "Rotations differ: " << isometry1 << " vs " << isometry2;
+      }
+    }
+  }
+  return testing::AssertionSuccess();
+}
+
+// A robot driving along x at 1 m/s while yawing at 0.5 rad/s.
+Isometry PoseAt(const double stamp) {
+  return Isometry::FromTranslation(Vector3{stamp, 0., 0.}) * Isometry::RotateAround(Vector3::kUnitZ, 0.5 * stamp);
+}
+
+GTEST_TEST(TransformBufferTest, InterpolatesBetweenSamples) {
+  TransformBuffer buffer(100, 10.);
+  EXPECT_TRUE(buffer.empty());
+  for (int i = 0; i <= 10; ++i) {
+    buffer.insert(0.1 * i, PoseAt(0.1 * i));
+  }
+  EXPECT_EQ(buffer.size(), 11u);
+  EXPECT_DOUBLE_EQ(buffer.oldest(), 0.);
+  EXPECT_DOUBLE_EQ(buffer.newest(), 1.);
+
+  // Exact stamps, including both ends.
+  EXPECT_TRUE(areAlmostEqual(buffer.lookup(0.), PoseAt(0.), kTolerance));
+  EXPECT_TRUE(areAlmostEqual(buffer.lookup(0.3), PoseAt(0.3), kTolerance));
+  EXPECT_TRUE(areAlmostEqual(buffer.lookup(1.), PoseAt(1.), kTolerance));
+  // Constant velocity motion about a fixed axis is reproduced exactly between samples.
+  for (const double stamp : {0.01, 0.25, 0.333, 0.5, 0.95}) {
+    EXPECT_TRUE(areAlmostEqual(buffer.lookup(stamp), PoseAt(stamp), kTolerance)) << stamp;
+    EXPECT_TRUE(areAlmostEqual(buffer.lookupQuaternion(stamp).toIsometry(), PoseAt(stamp), kTolerance)) << stamp;
+  }
+}
+
+GTEST_TEST(TransformBufferTest, BoundedByCapacity) {
+  TransformBuffer buffer(4, 100.);
+  for (int i = 0; i < 10; ++i) {
+    buffer.insert(i, PoseAt(i));
+  }
+  EXPECT_EQ(buffer.size(), 4u);
+  EXPECT_EQ(buffer.capacity(), 4u);
+  EXPECT_DOUBLE_EQ(buffer.oldest(), 6.);
+  EXPECT_DOUBLE_EQ(buffer.newest(), 9.);
+  EXPECT_THROW(buffer.lookup(5.5), std::out_of_range);
+  EXPECT_TRUE(areAlmostEqual(buffer.lookup(6.5), PoseAt(6.5), kTolerance));
+  EXPECT_TRUE(areAlmostEqual(buffer.lookup(8.75), PoseAt(8.75), kTolerance));
+}
+
+GTEST_TEST(TransformBufferTest, BoundedByRetention) {
+  TransformBuffer buffer(1000, 0.5);
+  for (int i = 0; i < 100; ++i) {
+    buffer.insert(0.1 * i, PoseAt(0.1 * i));
+  }
+  EXPECT_DOUBLE_EQ(buffer.newest(), 9.9);
+  EXPECT_GE(buffer.oldest(), 9.9 - 0.5);
+  EXPECT_LE(buffer.size(), 6u);
+  // A long gap keeps at least the newest sample.
+  buffer.insert(100., PoseAt(100.));
+  EXPECT_EQ(buffer.size(), 1u);
+  EXPECT_TRUE(areAlmostEqual(buffer.lookup(100.), PoseAt(100.), kTolerance));
+
+  buffer.clear();
+  EXPECT_TRUE(buffer.empty());
+  buffer.insert(1., PoseAt(1.));
+  EXPECT_DOUBLE_EQ(buffer.oldest(), 1.);
+}
+
+GTEST_TEST(TransformBufferTest, Errors) {
+  EXPECT_THROW(TransformBuffer(0, 1.), std::invalid_argument);
+  EXPECT_THROW(TransformBuffer(10, -1.), std::invalid_argument);
+
+  TransformBuffer buffer(10, 1.);
+  EXPECT_THROW(buffer.lookup(0.), std::out_of_range);
+  EXPECT_THROW(buffer.oldest(), std::out_of_range);
+  // Non-finite stamps are rejected even on an empty buffer, which stays usable.
+  EXPECT_THROW(buffer.insert(NAN, PoseAt(0.)), std::invalid_argument);
+  EXPECT_THROW(buffer.insert(INFINITY, PoseAt(0.)), std::invalid_argument);
+  EXPECT_TRUE(buffer.empty());
+  buffer.insert(1., PoseAt(1.));
+  EXPECT_THROW(buffer.insert(NAN, PoseAt(1.)), std::invalid_argument);
+  EXPECT_THROW(buffer.insert(1., PoseAt(1.)), std::invalid_argument);
+  EXPECT_THROW(buffer.insert(0.5, PoseAt(0.5)), std::invalid_argument);
+  EXPECT_THROW(buffer.lookup(1.5), std::out_of_range);
+  EXPECT_THROW(buffer.lookup(NAN), std::out_of_range);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace math
+}  // namespace ekumen
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,140 @@
+#include "transform_kernels.h"
+
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "isometry.h"
+
+#include "gtest/gtest.h"
+
+namespace ekumen {
+namespace math {
+namespace test {
+namespace {
+
+const std::vector<SimdLevel> kAllLevels{SimdLevel::kScalar, SimdLevel::kSse42, SimdLevel::kAvx2, SimdLevel::kNeon};
+
+template <class T>
+struct CloudT {
+  explicit CloudT(size_t size) : x(size), y(size), z(size) {}
+  std::vector<T> x, y, z;
+};
+
+using Cloud = CloudT<double>;
+
+template <class T = double>
+CloudT<T> RandomCloud(size_t size) {
+  std::mt19937 generator(42);
+  std::uniform_real_distribution<T> distribution(-100., 100.);
+  CloudT<T> cloud(size);
+  for (size_t i = 0; i < size; ++i) {
+    cloud.x[i] = distribution(generator);
+    cloud.y[i] = distribution(generator);
+    cloud.z[i] = distribution(generator);
+  }
+  return cloud;
+}
+
+GTEST_TEST(TransformKernelsTest, DetectedLevelIsSupported) {
+  EXPECT_TRUE(IsSupported(SimdLevel::kScalar));
+  EXPECT_TRUE(IsSupported(DetectSimdLevel()));
+}
+
+GTEST_TEST(TransformKernelsTest, KernelsMatchScalarBitForBit) {
+  const double rotation[9]{0.36, 0.48, -0.8, -0.8, 0.6, 0., 0.48, 0.64, 0.6};
+  const double translation[3]{1.5, -2.25, 3.125};
+  // Odd sizes exercise the scalar tails of the vector kernels.
+  for (const size_t size : {0u, 1u, 3u, 5u, 8u, 1027u}) {
+    const Cloud input = RandomCloud(size);
+    Cloud expected(size);
+    TransformSoA(SimdLevel::kScalar, rotation, translation, input.x.data(), input.y.data(), input.z.data(),
+                 expected.x.data(), expected.y.data(), expected.z.data(), size);
+    for (const SimdLevel level : kAllLevels) {
+      if (!IsSupported(level)) {
+        continue;
+      }
+      Cloud output(size);
+      TransformSoA(level, rotation, translation, input.x.data(), input.y.data(), input.z.data(), output.x.data(),
+                   output.y.data(), output.z.data(), size);
+      EXPECT_EQ(output.x, expected.x) << ToString(level);
+      EXPECT_EQ(output.y, expected.y) << ToString(level);
+      EXPECT_EQ(output.z, expected.z) << ToString(level);
+
+      // In place.
+      Cloud in_place = input;
+      TransformSoA(level, rotation, translation, in_place.x.data(), in_place.y.data(), in_place.z.data(),
+                   in_place.x.data(), in_place.y.data(), in_place.z.data(), size);
+      EXPECT_EQ(in_place.x, expected.x) << ToString(level);
+      EXPECT_EQ(in_place.y, expected.y) << ToString(level);
+      EXPECT_EQ(in_place.z, expected.z) << ToString(level);
+    }
+  }
+}
+
+GTEST_TEST(TransformKernelsTest, FloatKernelsMatchScalarBitForBit) {
+  const float rotation[9]{0.36f, 0.48f, -0.8f, -0.8f, 0.6f, 0.f, 0.48f, 0.64f, 0.6f};
+  const float translation[3]{1.5f, -2.25f, 3.125f};
+  for (const size_t size : {0u, 1u, 3u, 7u, 9u, 17u, 1027u}) {
+    const CloudT<float> input = RandomCloud<float>(size);
+    CloudT<float> expected(size);
+    TransformSoA(SimdLevel::kScalar, rotation, translation, input.x.data(), input.y.data(), input.z.data(),
+                 expected.x.data(), expected.y.data(), expected.z.data(), size);
+    for (const SimdLevel level : kAllLevels) {
+      if (!IsSupported(level)) {
+        continue;
+      }
+      CloudT<float> in_place = input;
+      TransformSoA(level, rotation, translation, in_place.x.data(), in_place.y.data(), in_place.z.data(),
+                   in_place.x.data(), in_place.y.data(), in_place.z.data(), size);
+      EXPECT_EQ(in_place.x, expected.x) << ToString(level);
+      EXPECT_EQ(in_place.y, expected.y) << ToString(level);
+      EXPECT_EQ(in_place.z, expected.z) << ToString(level);
+    }
+  }
+}
+
+GTEST_TEST(TransformKernelsTest, UnsupportedLevelThrows) {
+  for (const SimdLevel level : kAllLevels) {
+    if (IsSupported(level)) {
+      continue;
+    }
+    double value{0.};
+    const double rotation[9]{};
+    const double translation[3]{};
+    EXPECT_THROW(TransformSoA(level, rotation, translation, &value, &value, &value, &value, &value, &value, 1),
+                 std::invalid_argument);
+  }
+}
+
+GTEST_TEST(TransformKernelsTest, MatchesIsometryTransform) {
+  const Isometry t{Vector3{1., -2., 3.}, Isometry::RotateAround(Vector3::kUnitZ, M_PI / 5.).rotation()};
+  Cloud cloud = RandomCloud(37);
+  const Cloud input = cloud;
+  t.transform(cloud.x.data(), cloud.y.data(), cloud.z.data(), cloud.x.data(), cloud.y.data(), cloud.z.data(),
+              cloud.x.size());
+  for (size_t i = 0; i < input.x.size(); ++i) {
+    const Vector3 expected = t.transform(Vector3(input.x[i], input.y[i], input.z[i]));
+#ifdef EKUMEN_MATH_FMA
+    // The kernels never fuse, so they match the plain Vector3 products only to rounding.
+    EXPECT_NEAR(cloud.x[i], expected.x(), 1e-10);
+    EXPECT_NEAR(cloud.y[i], expected.y(), 1e-10);
+    EXPECT_NEAR(cloud.z[i], expected.z(), 1e-10);
+#else
+    EXPECT_EQ(cloud.x[i], expected.x());
+    EXPECT_EQ(cloud.y[i], expected.y());
+    EXPECT_EQ(cloud.z[i], expected.z());
+#endif
+  }
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace math
+}  // namespace ekumen
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}